@@ -38,6 +38,13 @@ typedef struct {
 // request close
 void cjam_quit();
 
+// request close, the process exits with status
+void cjam_exit(int status);
+
+// command line arguments passed to the client, argv[0] is the program name
+int cjam_argc();
+char **cjam_argv();
+
 #ifdef CJAM_IMPL
 
 #include "util/hooks.h"
@@ -49,6 +56,9 @@ void cjam_quit();
 typedef struct {
     cjam_desc_t desc;
     bool quit;
+    int status;
+    int argc;
+    char **argv;
 } cjam_state_t;
 
 static cjam_state_t _cj;
@@ -58,6 +68,19 @@ void cjam_quit() {
     _cj.quit = true;
 }
 
+void cjam_exit(int status) {
+    _cj.quit = true;
+    _cj.status = status;
+}
+
+int cjam_argc() {
+    return _cj.argc;
+}
+
+char **cjam_argv() {
+    return _cj.argv;
+}
+
 int RELOADHOST_ENTRY_NAME(
     int argc,
     char *argv[],
@@ -96,6 +119,8 @@ int RELOADHOST_ENTRY_NAME(
     reloadhost_op_e op,
     reloadhost_t *reloadhost) {
     g_reloadhost = reloadhost;
+    _cj.argc = argc;
+    _cj.argv = argv;
 
     switch (op) {
     case RELOADHOST_INIT:;
@@ -106,7 +131,7 @@ int RELOADHOST_ENTRY_NAME(
     case RELOADHOST_DEINIT:
         if (_cj.desc.deinit) { _cj.desc.deinit(); }
         hook_call_hooks(HOOK_EXIT);
-        return 0;
+        return _cj.status;
     case RELOADHOST_RELOAD:
         return 0;
     case RELOADHOST_PRE_RELOAD:
@@ -4,7 +4,9 @@
 
 #include "cute_sound.h" // IWYU pragma: keep
 #include "ext.h"        // IWYU pragma: keep
+#ifndef HEADLESS
 #include "gl.h"         // IWYU pragma: keep
+#endif // ifndef HEADLESS
 #include "sokol.h"      // IWYU pragma: keep
 
 #endif // ifdef EXT_IMPL
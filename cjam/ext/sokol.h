@@ -9,13 +9,18 @@
 #endif // ifndef EMSCRIPTEN
 
 
-#ifdef EMSCRIPTEN
+// headless builds never create a GL context, sokol calls are no-ops
+#if defined(HEADLESS)
+    #define SOKOL_DUMMY_BACKEND
+#elif defined(EMSCRIPTEN)
     #define SOKOL_GLES3
 #else
     #define SOKOL_GLCORE33
-#endif // ifdef EMSCRIPTEN
+#endif // if defined(HEADLESS)
 
+#ifndef HEADLESS
 #include "gl.h" /* IWYU pragma: keep */
+#endif // ifndef HEADLESS
 #include "../lib/sokol/sokol_gfx.h"
 
 #include "../util/types.h"
@@ -4,13 +4,12 @@
 in vec2 a_position;
 in vec2 a_texcoord0;
 
+// see sprite_instance_t in util/sprite.h
 in vec2 a_offset;
-in vec2 a_scale;
-in vec2 a_uvmin;
-in vec2 a_uvmax;
+in vec4 a_uv;
 in vec4 a_color;
 in float a_z;
-in float a_flags;
+in vec4 a_flags;
 
 uniform vs_params {
 	mat4 model;
@@ -23,6 +22,7 @@ out vec4 color;
 out float depth;
 
 // must match with util/sprite.h
+#define SPRITE_SUBPIXELS 16.0
 #define SPRITE_FLIP_X     (1 << 0)
 #define SPRITE_FLIP_Y     (1 << 1)
 #define SPRITE_ROTATE_CW  (1 << 2)
@@ -30,7 +30,7 @@ out float depth;
 
 void main() {
     vec2 texcoord = a_texcoord0;
-    const int flags = floatBitsToInt(a_flags);
+    const int flags = int(a_flags.x);
 
     if ((flags & SPRITE_FLIP_X) != 0) {
         texcoord.x = 1.0 - texcoord.x;
@@ -40,11 +40,12 @@ void main() {
         texcoord.y = 1.0 - texcoord.y;
     }
 
-    uv = a_uvmin + (texcoord * (a_uvmax - a_uvmin));
+    // in texels, normalized per fragment
+    uv = a_uv.xy + (texcoord * a_uv.zw);
     color = a_color;
     depth = a_z;
 
-    const vec2 ipos = a_offset + (a_scale * a_position);
+    const vec2 ipos = (a_offset / SPRITE_SUBPIXELS) + (a_uv.zw * a_position);
     gl_Position = proj * view * model * vec4(ipos, a_z, 1.0);
 }
 @end
@@ -60,7 +61,8 @@ in float depth;
 out vec4 frag_color;
 
 void main() {
-    frag_color = color * texture(sampler2D(tex, smp), uv);
+    const vec2 size = vec2(textureSize(sampler2D(tex, smp), 0));
+    frag_color = color * texture(sampler2D(tex, smp), uv / size);
     if (frag_color.a < 0.0001) {
         discard;
     }
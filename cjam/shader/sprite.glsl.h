@@ -15,12 +15,10 @@
                     ATTR_sprite_vs_a_position = 0
                     ATTR_sprite_vs_a_texcoord0 = 1
                     ATTR_sprite_vs_a_offset = 2
-                    ATTR_sprite_vs_a_scale = 3
-                    ATTR_sprite_vs_a_uvmin = 4
-                    ATTR_sprite_vs_a_uvmax = 5
-                    ATTR_sprite_vs_a_color = 6
-                    ATTR_sprite_vs_a_z = 7
-                    ATTR_sprite_vs_a_flags = 8
+                    ATTR_sprite_vs_a_uv = 3
+                    ATTR_sprite_vs_a_color = 4
+                    ATTR_sprite_vs_a_z = 5
+                    ATTR_sprite_vs_a_flags = 6
                 Uniform block 'vs_params':
                     C struct: sprite_vs_params_t
                     Bind slot: SLOT_sprite_vs_params = 0
@@ -49,9 +47,7 @@
                     [ATTR_sprite_vs_a_position] = { ... },
                     [ATTR_sprite_vs_a_texcoord0] = { ... },
                     [ATTR_sprite_vs_a_offset] = { ... },
-                    [ATTR_sprite_vs_a_scale] = { ... },
-                    [ATTR_sprite_vs_a_uvmin] = { ... },
-                    [ATTR_sprite_vs_a_uvmax] = { ... },
+                    [ATTR_sprite_vs_a_uv] = { ... },
                     [ATTR_sprite_vs_a_color] = { ... },
                     [ATTR_sprite_vs_a_z] = { ... },
                     [ATTR_sprite_vs_a_flags] = { ... },
@@ -92,12 +88,10 @@
 #define ATTR_sprite_vs_a_position (0)
 #define ATTR_sprite_vs_a_texcoord0 (1)
 #define ATTR_sprite_vs_a_offset (2)
-#define ATTR_sprite_vs_a_scale (3)
-#define ATTR_sprite_vs_a_uvmin (4)
-#define ATTR_sprite_vs_a_uvmax (5)
-#define ATTR_sprite_vs_a_color (6)
-#define ATTR_sprite_vs_a_z (7)
-#define ATTR_sprite_vs_a_flags (8)
+#define ATTR_sprite_vs_a_uv (3)
+#define ATTR_sprite_vs_a_color (4)
+#define ATTR_sprite_vs_a_z (5)
+#define ATTR_sprite_vs_a_flags (6)
 #define SLOT_sprite_tex (0)
 #define SLOT_sprite_smp (0)
 #define SLOT_sprite_vs_params (0)
@@ -113,22 +107,20 @@ SOKOL_SHDC_ALIGN(16) typedef struct sprite_vs_params_t {
     
     uniform vec4 vs_params[12];
     layout(location = 1) in vec2 a_texcoord0;
-    layout(location = 8) in float a_flags;
+    layout(location = 6) in vec4 a_flags;
     out vec2 uv;
-    layout(location = 4) in vec2 a_uvmin;
-    layout(location = 5) in vec2 a_uvmax;
+    layout(location = 3) in vec4 a_uv;
     out vec4 color;
-    layout(location = 6) in vec4 a_color;
+    layout(location = 4) in vec4 a_color;
     out float depth;
-    layout(location = 7) in float a_z;
+    layout(location = 5) in float a_z;
     layout(location = 2) in vec2 a_offset;
-    layout(location = 3) in vec2 a_scale;
     layout(location = 0) in vec2 a_position;
     
     void main()
     {
         vec2 texcoord = a_texcoord0;
-        int _19 = floatBitsToInt(a_flags);
+        int _19 = int(a_flags.x);
         if ((_19 & 1) != 0)
         {
             vec2 _101 = texcoord;
@@ -141,85 +133,79 @@ SOKOL_SHDC_ALIGN(16) typedef struct sprite_vs_params_t {
             _104.y = 1.0 - _104.y;
             texcoord = _104;
         }
-        uv = texcoord * (a_uvmax - a_uvmin) + a_uvmin;
+        uv = texcoord * a_uv.zw + a_uv.xy;
         color = a_color;
         depth = a_z;
-        gl_Position = ((mat4(vs_params[8], vs_params[9], vs_params[10], vs_params[11]) * mat4(vs_params[4], vs_params[5], vs_params[6], vs_params[7])) * mat4(vs_params[0], vs_params[1], vs_params[2], vs_params[3])) * vec4(a_scale * a_position + a_offset, a_z, 1.0);
+        gl_Position = ((mat4(vs_params[8], vs_params[9], vs_params[10], vs_params[11]) * mat4(vs_params[4], vs_params[5], vs_params[6], vs_params[7])) * mat4(vs_params[0], vs_params[1], vs_params[2], vs_params[3])) * vec4(a_offset / vec2(16.0) + a_uv.zw * a_position, a_z, 1.0);
     }
     
 */
-static const char sprite_vs_source_glsl330[1122] = {
+static const char sprite_vs_source_glsl330[1034] = {
     0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x33,0x33,0x30,0x0a,0x0a,0x75,0x6e,
     0x69,0x66,0x6f,0x72,0x6d,0x20,0x76,0x65,0x63,0x34,0x20,0x76,0x73,0x5f,0x70,0x61,
     0x72,0x61,0x6d,0x73,0x5b,0x31,0x32,0x5d,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,
     0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x31,0x29,0x20,0x69,
     0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x61,0x5f,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,
     0x64,0x30,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,
-    0x69,0x6f,0x6e,0x20,0x3d,0x20,0x38,0x29,0x20,0x69,0x6e,0x20,0x66,0x6c,0x6f,0x61,
-    0x74,0x20,0x61,0x5f,0x66,0x6c,0x61,0x67,0x73,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,
-    0x65,0x63,0x32,0x20,0x75,0x76,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,
-    0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x34,0x29,0x20,0x69,0x6e,0x20,
-    0x76,0x65,0x63,0x32,0x20,0x61,0x5f,0x75,0x76,0x6d,0x69,0x6e,0x3b,0x0a,0x6c,0x61,
-    0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,
-    0x35,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x61,0x5f,0x75,0x76,0x6d,
-    0x61,0x78,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x34,0x20,0x63,0x6f,0x6c,
-    0x6f,0x72,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,
     0x69,0x6f,0x6e,0x20,0x3d,0x20,0x36,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,
-    0x20,0x61,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x66,0x6c,
-    0x6f,0x61,0x74,0x20,0x64,0x65,0x70,0x74,0x68,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,
-    0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x37,0x29,0x20,
-    0x69,0x6e,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x61,0x5f,0x7a,0x3b,0x0a,0x6c,0x61,
-    0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,
-    0x32,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x61,0x5f,0x6f,0x66,0x66,
-    0x73,0x65,0x74,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,
-    0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x33,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,
-    0x32,0x20,0x61,0x5f,0x73,0x63,0x61,0x6c,0x65,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,
+    0x20,0x61,0x5f,0x66,0x6c,0x61,0x67,0x73,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,
+    0x63,0x32,0x20,0x75,0x76,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,
+    0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x33,0x29,0x20,0x69,0x6e,0x20,0x76,
+    0x65,0x63,0x34,0x20,0x61,0x5f,0x75,0x76,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,
+    0x63,0x34,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,
+    0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x34,0x29,0x20,0x69,
+    0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x61,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,
+    0x6f,0x75,0x74,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x64,0x65,0x70,0x74,0x68,0x3b,
+    0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,
+    0x20,0x3d,0x20,0x35,0x29,0x20,0x69,0x6e,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x61,
+    0x5f,0x7a,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,
+    0x69,0x6f,0x6e,0x20,0x3d,0x20,0x32,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,
+    0x20,0x61,0x5f,0x6f,0x66,0x66,0x73,0x65,0x74,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,
     0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x30,0x29,0x20,
     0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x61,0x5f,0x70,0x6f,0x73,0x69,0x74,0x69,
     0x6f,0x6e,0x3b,0x0a,0x0a,0x76,0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,0x6e,0x28,0x29,
     0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x32,0x20,0x74,0x65,0x78,0x63,
     0x6f,0x6f,0x72,0x64,0x20,0x3d,0x20,0x61,0x5f,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,
     0x64,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x6e,0x74,0x20,0x5f,0x31,0x39,0x20,
-    0x3d,0x20,0x66,0x6c,0x6f,0x61,0x74,0x42,0x69,0x74,0x73,0x54,0x6f,0x49,0x6e,0x74,
-    0x28,0x61,0x5f,0x66,0x6c,0x61,0x67,0x73,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,
-    0x66,0x20,0x28,0x28,0x5f,0x31,0x39,0x20,0x26,0x20,0x31,0x29,0x20,0x21,0x3d,0x20,
-    0x30,0x29,0x0a,0x20,0x20,0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,
-    0x20,0x76,0x65,0x63,0x32,0x20,0x5f,0x31,0x30,0x31,0x20,0x3d,0x20,0x74,0x65,0x78,
-    0x63,0x6f,0x6f,0x72,0x64,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x5f,
-    0x31,0x30,0x31,0x2e,0x78,0x20,0x3d,0x20,0x31,0x2e,0x30,0x20,0x2d,0x20,0x5f,0x31,
-    0x30,0x31,0x2e,0x78,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x74,0x65,
-    0x78,0x63,0x6f,0x6f,0x72,0x64,0x20,0x3d,0x20,0x5f,0x31,0x30,0x31,0x3b,0x0a,0x20,
-    0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,0x20,0x69,0x66,0x20,0x28,0x28,0x5f,0x31,
-    0x39,0x20,0x26,0x20,0x32,0x29,0x20,0x21,0x3d,0x20,0x30,0x29,0x0a,0x20,0x20,0x20,
-    0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x32,0x20,
-    0x5f,0x31,0x30,0x34,0x20,0x3d,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x3b,
-    0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x5f,0x31,0x30,0x34,0x2e,0x79,0x20,
-    0x3d,0x20,0x31,0x2e,0x30,0x20,0x2d,0x20,0x5f,0x31,0x30,0x34,0x2e,0x79,0x3b,0x0a,
-    0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,
-    0x20,0x3d,0x20,0x5f,0x31,0x30,0x34,0x3b,0x0a,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,
-    0x20,0x20,0x20,0x75,0x76,0x20,0x3d,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,
-    0x20,0x2a,0x20,0x28,0x61,0x5f,0x75,0x76,0x6d,0x61,0x78,0x20,0x2d,0x20,0x61,0x5f,
-    0x75,0x76,0x6d,0x69,0x6e,0x29,0x20,0x2b,0x20,0x61,0x5f,0x75,0x76,0x6d,0x69,0x6e,
-    0x3b,0x0a,0x20,0x20,0x20,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x61,0x5f,
-    0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,0x20,0x20,0x64,0x65,0x70,0x74,0x68,
-    0x20,0x3d,0x20,0x61,0x5f,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,
-    0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x28,0x28,0x6d,0x61,0x74,0x34,
-    0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x38,0x5d,0x2c,0x20,0x76,
-    0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x39,0x5d,0x2c,0x20,0x76,0x73,0x5f,
-    0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x30,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,
-    0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x31,0x5d,0x29,0x20,0x2a,0x20,0x6d,0x61,0x74,
-    0x34,0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x34,0x5d,0x2c,0x20,
-    0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x35,0x5d,0x2c,0x20,0x76,0x73,
-    0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x36,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,
-    0x61,0x72,0x61,0x6d,0x73,0x5b,0x37,0x5d,0x29,0x29,0x20,0x2a,0x20,0x6d,0x61,0x74,
-    0x34,0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x30,0x5d,0x2c,0x20,
-    0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x5d,0x2c,0x20,0x76,0x73,
-    0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x32,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,
-    0x61,0x72,0x61,0x6d,0x73,0x5b,0x33,0x5d,0x29,0x29,0x20,0x2a,0x20,0x76,0x65,0x63,
-    0x34,0x28,0x61,0x5f,0x73,0x63,0x61,0x6c,0x65,0x20,0x2a,0x20,0x61,0x5f,0x70,0x6f,
-    0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x2b,0x20,0x61,0x5f,0x6f,0x66,0x66,0x73,0x65,
-    0x74,0x2c,0x20,0x61,0x5f,0x7a,0x2c,0x20,0x31,0x2e,0x30,0x29,0x3b,0x0a,0x7d,0x0a,
-    0x0a,0x00,
+    0x3d,0x20,0x69,0x6e,0x74,0x28,0x61,0x5f,0x66,0x6c,0x61,0x67,0x73,0x2e,0x78,0x29,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x66,0x20,0x28,0x28,0x5f,0x31,0x39,0x20,0x26,
+    0x20,0x31,0x29,0x20,0x21,0x3d,0x20,0x30,0x29,0x0a,0x20,0x20,0x20,0x20,0x7b,0x0a,
+    0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x32,0x20,0x5f,0x31,0x30,
+    0x31,0x20,0x3d,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x3b,0x0a,0x20,0x20,
+    0x20,0x20,0x20,0x20,0x20,0x20,0x5f,0x31,0x30,0x31,0x2e,0x78,0x20,0x3d,0x20,0x31,
+    0x2e,0x30,0x20,0x2d,0x20,0x5f,0x31,0x30,0x31,0x2e,0x78,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x20,0x20,0x20,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x20,0x3d,0x20,
+    0x5f,0x31,0x30,0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,0x20,
+    0x69,0x66,0x20,0x28,0x28,0x5f,0x31,0x39,0x20,0x26,0x20,0x32,0x29,0x20,0x21,0x3d,
+    0x20,0x30,0x29,0x0a,0x20,0x20,0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,
+    0x20,0x20,0x76,0x65,0x63,0x32,0x20,0x5f,0x31,0x30,0x34,0x20,0x3d,0x20,0x74,0x65,
+    0x78,0x63,0x6f,0x6f,0x72,0x64,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,
+    0x5f,0x31,0x30,0x34,0x2e,0x79,0x20,0x3d,0x20,0x31,0x2e,0x30,0x20,0x2d,0x20,0x5f,
+    0x31,0x30,0x34,0x2e,0x79,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x74,
+    0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x20,0x3d,0x20,0x5f,0x31,0x30,0x34,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,0x20,0x75,0x76,0x20,0x3d,0x20,0x74,
+    0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x20,0x2a,0x20,0x61,0x5f,0x75,0x76,0x2e,0x7a,
+    0x77,0x20,0x2b,0x20,0x61,0x5f,0x75,0x76,0x2e,0x78,0x79,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x61,0x5f,0x63,0x6f,0x6c,0x6f,0x72,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x64,0x65,0x70,0x74,0x68,0x20,0x3d,0x20,0x61,0x5f,
+    0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,
+    0x6f,0x6e,0x20,0x3d,0x20,0x28,0x28,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x70,
+    0x61,0x72,0x61,0x6d,0x73,0x5b,0x38,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,
+    0x61,0x6d,0x73,0x5b,0x39,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,
+    0x73,0x5b,0x31,0x30,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,
+    0x5b,0x31,0x31,0x5d,0x29,0x20,0x2a,0x20,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,
+    0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x34,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,
+    0x72,0x61,0x6d,0x73,0x5b,0x35,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,
+    0x6d,0x73,0x5b,0x36,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,
+    0x5b,0x37,0x5d,0x29,0x29,0x20,0x2a,0x20,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,
+    0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x30,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,
+    0x72,0x61,0x6d,0x73,0x5b,0x31,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,
+    0x6d,0x73,0x5b,0x32,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,
+    0x5b,0x33,0x5d,0x29,0x29,0x20,0x2a,0x20,0x76,0x65,0x63,0x34,0x28,0x61,0x5f,0x6f,
+    0x66,0x66,0x73,0x65,0x74,0x20,0x2f,0x20,0x76,0x65,0x63,0x32,0x28,0x31,0x36,0x2e,
+    0x30,0x29,0x20,0x2b,0x20,0x61,0x5f,0x75,0x76,0x2e,0x7a,0x77,0x20,0x2a,0x20,0x61,
+    0x5f,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x2c,0x20,0x61,0x5f,0x7a,0x2c,0x20,
+    0x31,0x2e,0x30,0x29,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
 };
 /*
     #version 330
@@ -233,7 +219,7 @@ static const char sprite_vs_source_glsl330[1122] = {
     
     void main()
     {
-        frag_color = color * texture(tex_smp, uv);
+        frag_color = color * texture(tex_smp, uv / vec2(textureSize(tex_smp, 0)));
         if (frag_color.w < 9.9999997473787516355514526367188e-05)
         {
             discard;
@@ -241,7 +227,7 @@ static const char sprite_vs_source_glsl330[1122] = {
     }
     
 */
-static const char sprite_fs_source_glsl330[284] = {
+static const char sprite_fs_source_glsl330[316] = {
     0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x33,0x33,0x30,0x0a,0x0a,0x75,0x6e,
     0x69,0x66,0x6f,0x72,0x6d,0x20,0x73,0x61,0x6d,0x70,0x6c,0x65,0x72,0x32,0x44,0x20,
     0x74,0x65,0x78,0x5f,0x73,0x6d,0x70,0x3b,0x0a,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,
@@ -253,7 +239,9 @@ static const char sprite_fs_source_glsl330[284] = {
     0x76,0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x20,0x20,
     0x20,0x20,0x66,0x72,0x61,0x67,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x63,
     0x6f,0x6c,0x6f,0x72,0x20,0x2a,0x20,0x74,0x65,0x78,0x74,0x75,0x72,0x65,0x28,0x74,
-    0x65,0x78,0x5f,0x73,0x6d,0x70,0x2c,0x20,0x75,0x76,0x29,0x3b,0x0a,0x20,0x20,0x20,
+    0x65,0x78,0x5f,0x73,0x6d,0x70,0x2c,0x20,0x75,0x76,0x20,0x2f,0x20,0x76,0x65,0x63,
+    0x32,0x28,0x74,0x65,0x78,0x74,0x75,0x72,0x65,0x53,0x69,0x7a,0x65,0x28,0x74,0x65,
+    0x78,0x5f,0x73,0x6d,0x70,0x2c,0x20,0x30,0x29,0x29,0x29,0x3b,0x0a,0x20,0x20,0x20,
     0x20,0x69,0x66,0x20,0x28,0x66,0x72,0x61,0x67,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x2e,
     0x77,0x20,0x3c,0x20,0x39,0x2e,0x39,0x39,0x39,0x39,0x39,0x39,0x37,0x34,0x37,0x33,
     0x37,0x38,0x37,0x35,0x31,0x36,0x33,0x35,0x35,0x35,0x31,0x34,0x35,0x32,0x36,0x33,
@@ -266,22 +254,20 @@ static const char sprite_fs_source_glsl330[284] = {
     
     uniform vec4 vs_params[12];
     layout(location = 1) in vec2 a_texcoord0;
-    layout(location = 8) in float a_flags;
+    layout(location = 6) in vec4 a_flags;
     out vec2 uv;
-    layout(location = 4) in vec2 a_uvmin;
-    layout(location = 5) in vec2 a_uvmax;
+    layout(location = 3) in vec4 a_uv;
     out vec4 color;
-    layout(location = 6) in vec4 a_color;
+    layout(location = 4) in vec4 a_color;
     out float depth;
-    layout(location = 7) in float a_z;
+    layout(location = 5) in float a_z;
     layout(location = 2) in vec2 a_offset;
-    layout(location = 3) in vec2 a_scale;
     layout(location = 0) in vec2 a_position;
     
     void main()
     {
         vec2 texcoord = a_texcoord0;
-        int _19 = floatBitsToInt(a_flags);
+        int _19 = int(a_flags.x);
         if ((_19 & 1) != 0)
         {
             vec2 _101 = texcoord;
@@ -294,85 +280,79 @@ static const char sprite_fs_source_glsl330[284] = {
             _104.y = 1.0 - _104.y;
             texcoord = _104;
         }
-        uv = texcoord * (a_uvmax - a_uvmin) + a_uvmin;
+        uv = texcoord * a_uv.zw + a_uv.xy;
         color = a_color;
         depth = a_z;
-        gl_Position = ((mat4(vs_params[8], vs_params[9], vs_params[10], vs_params[11]) * mat4(vs_params[4], vs_params[5], vs_params[6], vs_params[7])) * mat4(vs_params[0], vs_params[1], vs_params[2], vs_params[3])) * vec4(a_scale * a_position + a_offset, a_z, 1.0);
+        gl_Position = ((mat4(vs_params[8], vs_params[9], vs_params[10], vs_params[11]) * mat4(vs_params[4], vs_params[5], vs_params[6], vs_params[7])) * mat4(vs_params[0], vs_params[1], vs_params[2], vs_params[3])) * vec4(a_offset / vec2(16.0) + a_uv.zw * a_position, a_z, 1.0);
     }
     
 */
-static const char sprite_vs_source_glsl300es[1125] = {
+static const char sprite_vs_source_glsl300es[1037] = {
     0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x33,0x30,0x30,0x20,0x65,0x73,0x0a,
     0x0a,0x75,0x6e,0x69,0x66,0x6f,0x72,0x6d,0x20,0x76,0x65,0x63,0x34,0x20,0x76,0x73,
     0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x32,0x5d,0x3b,0x0a,0x6c,0x61,0x79,
     0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x31,
     0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x61,0x5f,0x74,0x65,0x78,0x63,
     0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,
-    0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x38,0x29,0x20,0x69,0x6e,0x20,0x66,
-    0x6c,0x6f,0x61,0x74,0x20,0x61,0x5f,0x66,0x6c,0x61,0x67,0x73,0x3b,0x0a,0x6f,0x75,
-    0x74,0x20,0x76,0x65,0x63,0x32,0x20,0x75,0x76,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,
-    0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x34,0x29,0x20,
-    0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x61,0x5f,0x75,0x76,0x6d,0x69,0x6e,0x3b,
-    0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,
-    0x20,0x3d,0x20,0x35,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x61,0x5f,
-    0x75,0x76,0x6d,0x61,0x78,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x34,0x20,
-    0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,
     0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x36,0x29,0x20,0x69,0x6e,0x20,0x76,
-    0x65,0x63,0x34,0x20,0x61,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x6f,0x75,0x74,
-    0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x64,0x65,0x70,0x74,0x68,0x3b,0x0a,0x6c,0x61,
-    0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,
-    0x37,0x29,0x20,0x69,0x6e,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x61,0x5f,0x7a,0x3b,
-    0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,
-    0x20,0x3d,0x20,0x32,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x61,0x5f,
-    0x6f,0x66,0x66,0x73,0x65,0x74,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,
-    0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x33,0x29,0x20,0x69,0x6e,0x20,
-    0x76,0x65,0x63,0x32,0x20,0x61,0x5f,0x73,0x63,0x61,0x6c,0x65,0x3b,0x0a,0x6c,0x61,
+    0x65,0x63,0x34,0x20,0x61,0x5f,0x66,0x6c,0x61,0x67,0x73,0x3b,0x0a,0x6f,0x75,0x74,
+    0x20,0x76,0x65,0x63,0x32,0x20,0x75,0x76,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,
+    0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x33,0x29,0x20,0x69,
+    0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x61,0x5f,0x75,0x76,0x3b,0x0a,0x6f,0x75,0x74,
+    0x20,0x76,0x65,0x63,0x34,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x6c,0x61,0x79,
+    0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x34,
+    0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x61,0x5f,0x63,0x6f,0x6c,0x6f,
+    0x72,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x64,0x65,0x70,
+    0x74,0x68,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,
+    0x69,0x6f,0x6e,0x20,0x3d,0x20,0x35,0x29,0x20,0x69,0x6e,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x20,0x61,0x5f,0x7a,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,
+    0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x32,0x29,0x20,0x69,0x6e,0x20,0x76,
+    0x65,0x63,0x32,0x20,0x61,0x5f,0x6f,0x66,0x66,0x73,0x65,0x74,0x3b,0x0a,0x6c,0x61,
     0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,
     0x30,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x61,0x5f,0x70,0x6f,0x73,
     0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x0a,0x76,0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,
     0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x32,0x20,0x74,
     0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x20,0x3d,0x20,0x61,0x5f,0x74,0x65,0x78,0x63,
     0x6f,0x6f,0x72,0x64,0x30,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x6e,0x74,0x20,0x5f,
-    0x31,0x39,0x20,0x3d,0x20,0x66,0x6c,0x6f,0x61,0x74,0x42,0x69,0x74,0x73,0x54,0x6f,
-    0x49,0x6e,0x74,0x28,0x61,0x5f,0x66,0x6c,0x61,0x67,0x73,0x29,0x3b,0x0a,0x20,0x20,
-    0x20,0x20,0x69,0x66,0x20,0x28,0x28,0x5f,0x31,0x39,0x20,0x26,0x20,0x31,0x29,0x20,
-    0x21,0x3d,0x20,0x30,0x29,0x0a,0x20,0x20,0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,
-    0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x32,0x20,0x5f,0x31,0x30,0x31,0x20,0x3d,0x20,
-    0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,
-    0x20,0x20,0x5f,0x31,0x30,0x31,0x2e,0x78,0x20,0x3d,0x20,0x31,0x2e,0x30,0x20,0x2d,
-    0x20,0x5f,0x31,0x30,0x31,0x2e,0x78,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,
-    0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x20,0x3d,0x20,0x5f,0x31,0x30,0x31,
-    0x3b,0x0a,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,0x20,0x69,0x66,0x20,0x28,
-    0x28,0x5f,0x31,0x39,0x20,0x26,0x20,0x32,0x29,0x20,0x21,0x3d,0x20,0x30,0x29,0x0a,
-    0x20,0x20,0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x76,0x65,
-    0x63,0x32,0x20,0x5f,0x31,0x30,0x34,0x20,0x3d,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,
-    0x72,0x64,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x5f,0x31,0x30,0x34,
-    0x2e,0x79,0x20,0x3d,0x20,0x31,0x2e,0x30,0x20,0x2d,0x20,0x5f,0x31,0x30,0x34,0x2e,
-    0x79,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x74,0x65,0x78,0x63,0x6f,
-    0x6f,0x72,0x64,0x20,0x3d,0x20,0x5f,0x31,0x30,0x34,0x3b,0x0a,0x20,0x20,0x20,0x20,
-    0x7d,0x0a,0x20,0x20,0x20,0x20,0x75,0x76,0x20,0x3d,0x20,0x74,0x65,0x78,0x63,0x6f,
-    0x6f,0x72,0x64,0x20,0x2a,0x20,0x28,0x61,0x5f,0x75,0x76,0x6d,0x61,0x78,0x20,0x2d,
-    0x20,0x61,0x5f,0x75,0x76,0x6d,0x69,0x6e,0x29,0x20,0x2b,0x20,0x61,0x5f,0x75,0x76,
-    0x6d,0x69,0x6e,0x3b,0x0a,0x20,0x20,0x20,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,
-    0x20,0x61,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,0x20,0x20,0x64,0x65,
-    0x70,0x74,0x68,0x20,0x3d,0x20,0x61,0x5f,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x67,
-    0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x28,0x28,0x6d,
-    0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x38,0x5d,
-    0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x39,0x5d,0x2c,0x20,
-    0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x30,0x5d,0x2c,0x20,0x76,
-    0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x31,0x5d,0x29,0x20,0x2a,0x20,
-    0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x34,
-    0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x35,0x5d,0x2c,
-    0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x36,0x5d,0x2c,0x20,0x76,
-    0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x37,0x5d,0x29,0x29,0x20,0x2a,0x20,
-    0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x30,
-    0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x5d,0x2c,
-    0x20,0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x32,0x5d,0x2c,0x20,0x76,
-    0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x33,0x5d,0x29,0x29,0x20,0x2a,0x20,
-    0x76,0x65,0x63,0x34,0x28,0x61,0x5f,0x73,0x63,0x61,0x6c,0x65,0x20,0x2a,0x20,0x61,
-    0x5f,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x20,0x2b,0x20,0x61,0x5f,0x6f,0x66,
-    0x66,0x73,0x65,0x74,0x2c,0x20,0x61,0x5f,0x7a,0x2c,0x20,0x31,0x2e,0x30,0x29,0x3b,
-    0x0a,0x7d,0x0a,0x0a,0x00,
+    0x31,0x39,0x20,0x3d,0x20,0x69,0x6e,0x74,0x28,0x61,0x5f,0x66,0x6c,0x61,0x67,0x73,
+    0x2e,0x78,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x66,0x20,0x28,0x28,0x5f,0x31,
+    0x39,0x20,0x26,0x20,0x31,0x29,0x20,0x21,0x3d,0x20,0x30,0x29,0x0a,0x20,0x20,0x20,
+    0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x32,0x20,
+    0x5f,0x31,0x30,0x31,0x20,0x3d,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x5f,0x31,0x30,0x31,0x2e,0x78,0x20,
+    0x3d,0x20,0x31,0x2e,0x30,0x20,0x2d,0x20,0x5f,0x31,0x30,0x31,0x2e,0x78,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,
+    0x20,0x3d,0x20,0x5f,0x31,0x30,0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,
+    0x20,0x20,0x20,0x69,0x66,0x20,0x28,0x28,0x5f,0x31,0x39,0x20,0x26,0x20,0x32,0x29,
+    0x20,0x21,0x3d,0x20,0x30,0x29,0x0a,0x20,0x20,0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,
+    0x20,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x32,0x20,0x5f,0x31,0x30,0x34,0x20,0x3d,
+    0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,
+    0x20,0x20,0x20,0x5f,0x31,0x30,0x34,0x2e,0x79,0x20,0x3d,0x20,0x31,0x2e,0x30,0x20,
+    0x2d,0x20,0x5f,0x31,0x30,0x34,0x2e,0x79,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,
+    0x20,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x20,0x3d,0x20,0x5f,0x31,0x30,
+    0x34,0x3b,0x0a,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,0x20,0x75,0x76,0x20,
+    0x3d,0x20,0x74,0x65,0x78,0x63,0x6f,0x6f,0x72,0x64,0x20,0x2a,0x20,0x61,0x5f,0x75,
+    0x76,0x2e,0x7a,0x77,0x20,0x2b,0x20,0x61,0x5f,0x75,0x76,0x2e,0x78,0x79,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x61,0x5f,0x63,0x6f,
+    0x6c,0x6f,0x72,0x3b,0x0a,0x20,0x20,0x20,0x20,0x64,0x65,0x70,0x74,0x68,0x20,0x3d,
+    0x20,0x61,0x5f,0x7a,0x3b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,
+    0x69,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x28,0x28,0x6d,0x61,0x74,0x34,0x28,0x76,
+    0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x38,0x5d,0x2c,0x20,0x76,0x73,0x5f,
+    0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x39,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,
+    0x72,0x61,0x6d,0x73,0x5b,0x31,0x30,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,
+    0x61,0x6d,0x73,0x5b,0x31,0x31,0x5d,0x29,0x20,0x2a,0x20,0x6d,0x61,0x74,0x34,0x28,
+    0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x34,0x5d,0x2c,0x20,0x76,0x73,
+    0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x35,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,
+    0x61,0x72,0x61,0x6d,0x73,0x5b,0x36,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,
+    0x61,0x6d,0x73,0x5b,0x37,0x5d,0x29,0x29,0x20,0x2a,0x20,0x6d,0x61,0x74,0x34,0x28,
+    0x76,0x73,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x30,0x5d,0x2c,0x20,0x76,0x73,
+    0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,
+    0x61,0x72,0x61,0x6d,0x73,0x5b,0x32,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x70,0x61,0x72,
+    0x61,0x6d,0x73,0x5b,0x33,0x5d,0x29,0x29,0x20,0x2a,0x20,0x76,0x65,0x63,0x34,0x28,
+    0x61,0x5f,0x6f,0x66,0x66,0x73,0x65,0x74,0x20,0x2f,0x20,0x76,0x65,0x63,0x32,0x28,
+    0x31,0x36,0x2e,0x30,0x29,0x20,0x2b,0x20,0x61,0x5f,0x75,0x76,0x2e,0x7a,0x77,0x20,
+    0x2a,0x20,0x61,0x5f,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x2c,0x20,0x61,0x5f,
+    0x7a,0x2c,0x20,0x31,0x2e,0x30,0x29,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
 };
 /*
     #version 300 es
@@ -388,7 +368,7 @@ static const char sprite_vs_source_glsl300es[1125] = {
     
     void main()
     {
-        frag_color = color * texture(tex_smp, uv);
+        frag_color = color * texture(tex_smp, uv / vec2(textureSize(tex_smp, 0)));
         if (frag_color.w < 9.9999997473787516355514526367188e-05)
         {
             discard;
@@ -396,7 +376,7 @@ static const char sprite_vs_source_glsl300es[1125] = {
     }
     
 */
-static const char sprite_fs_source_glsl300es[363] = {
+static const char sprite_fs_source_glsl300es[395] = {
     0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x33,0x30,0x30,0x20,0x65,0x73,0x0a,
     0x70,0x72,0x65,0x63,0x69,0x73,0x69,0x6f,0x6e,0x20,0x6d,0x65,0x64,0x69,0x75,0x6d,
     0x70,0x20,0x66,0x6c,0x6f,0x61,0x74,0x3b,0x0a,0x70,0x72,0x65,0x63,0x69,0x73,0x69,
@@ -413,7 +393,9 @@ static const char sprite_fs_source_glsl300es[363] = {
     0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,0x6e,0x28,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,
     0x20,0x66,0x72,0x61,0x67,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x20,0x3d,0x20,0x63,0x6f,
     0x6c,0x6f,0x72,0x20,0x2a,0x20,0x74,0x65,0x78,0x74,0x75,0x72,0x65,0x28,0x74,0x65,
-    0x78,0x5f,0x73,0x6d,0x70,0x2c,0x20,0x75,0x76,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,
+    0x78,0x5f,0x73,0x6d,0x70,0x2c,0x20,0x75,0x76,0x20,0x2f,0x20,0x76,0x65,0x63,0x32,
+    0x28,0x74,0x65,0x78,0x74,0x75,0x72,0x65,0x53,0x69,0x7a,0x65,0x28,0x74,0x65,0x78,
+    0x5f,0x73,0x6d,0x70,0x2c,0x20,0x30,0x29,0x29,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,
     0x69,0x66,0x20,0x28,0x66,0x72,0x61,0x67,0x5f,0x63,0x6f,0x6c,0x6f,0x72,0x2e,0x77,
     0x20,0x3c,0x20,0x39,0x2e,0x39,0x39,0x39,0x39,0x39,0x39,0x37,0x34,0x37,0x33,0x37,
     0x38,0x37,0x35,0x31,0x36,0x33,0x35,0x35,0x35,0x31,0x34,0x35,0x32,0x36,0x33,0x36,
@@ -433,12 +415,10 @@ static inline const sg_shader_desc* sprite_sprite_shader_desc(sg_backend backend
       desc.attrs[0].name = "a_position";
       desc.attrs[1].name = "a_texcoord0";
       desc.attrs[2].name = "a_offset";
-      desc.attrs[3].name = "a_scale";
-      desc.attrs[4].name = "a_uvmin";
-      desc.attrs[5].name = "a_uvmax";
-      desc.attrs[6].name = "a_color";
-      desc.attrs[7].name = "a_z";
-      desc.attrs[8].name = "a_flags";
+      desc.attrs[3].name = "a_uv";
+      desc.attrs[4].name = "a_color";
+      desc.attrs[5].name = "a_z";
+      desc.attrs[6].name = "a_flags";
       desc.vs.source = sprite_vs_source_glsl330;
       desc.vs.entry = "main";
       desc.vs.uniform_blocks[0].size = 192;
@@ -470,12 +450,10 @@ static inline const sg_shader_desc* sprite_sprite_shader_desc(sg_backend backend
       desc.attrs[0].name = "a_position";
       desc.attrs[1].name = "a_texcoord0";
       desc.attrs[2].name = "a_offset";
-      desc.attrs[3].name = "a_scale";
-      desc.attrs[4].name = "a_uvmin";
-      desc.attrs[5].name = "a_uvmax";
-      desc.attrs[6].name = "a_color";
-      desc.attrs[7].name = "a_z";
-      desc.attrs[8].name = "a_flags";
+      desc.attrs[3].name = "a_uv";
+      desc.attrs[4].name = "a_color";
+      desc.attrs[5].name = "a_z";
+      desc.attrs[6].name = "a_flags";
       desc.vs.source = sprite_vs_source_glsl300es;
       desc.vs.entry = "main";
       desc.vs.uniform_blocks[0].size = 192;
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "types.h"
+#include "macros.h"
+#include "alloc.h"
+#include "bitmap.h"
+#include "blklist.h"
+
+// implements archetype_t, storage for entities which all have the same set of
+// components (columns)
+//
+// built on blklist_t, one blklist element is one entity. each block stores its
+// entities column-major so every column of a block is a contiguous array which
+// systems can run over in tight loops. entity indices are stable and allocated
+// exactly as blklist indices are. blocks share no data, so a system which
+// only touches the block it is given can run over disjoint block ranges in
+// parallel.
+
+#define ARCHETYPE_MAX_COLUMNS 8
+
+typedef struct archetype {
+    // element is one entity, t_size is the sum of column sizes
+    blklist_t list;
+
+    int n_columns;
+
+    // size of one element of each column, offset of each column into block
+    // data
+    i32 column_size[ARCHETYPE_MAX_COLUMNS];
+    i32 column_offset[ARCHETYPE_MAX_COLUMNS];
+} archetype_t;
+
+// one allocated block of an archetype
+typedef struct {
+    // block index, index of first entity in block
+    i32 index, base;
+
+    // number of entity slots in block
+    i32 size;
+
+    // bit i is set if entity base + i is present, absent slots hold junk
+    const bitmap_t *bits;
+
+    // column arrays, size elements each
+    void *columns[ARCHETYPE_MAX_COLUMNS];
+} archetype_block_t;
+
+// system run over one block at a time
+typedef void (*archetype_system_f)(
+    archetype_t *a,
+    const archetype_block_t *block,
+    void *userdata);
+
+// initializes an archetype with n_columns columns of column_sizes bytes per
+// entity. block_size must be a multiple of MAX_ALIGN so every column is
+// aligned
+void archetype_init(
+    archetype_t *a,
+    allocator_t *al,
+    int block_size,
+    int n_columns,
+    const usize *column_sizes);
+
+void archetype_destroy(archetype_t *a);
+
+void archetype_clear(archetype_t *a);
+
+// add entity at any index, returns its index. components are uninitialized
+i32 archetype_add(archetype_t *a);
+
+// removes entity at index
+void archetype_remove(archetype_t *a, i32 index);
+
+// true if entity at index exists
+bool archetype_present(const archetype_t *a, i32 index);
+
+// get pointer to column of entity at index
+void *archetype_ptr_voidp(const archetype_t *a, int column, i32 index);
+
+// number of block slots, see archetype_block
+i32 archetype_block_count(const archetype_t *a);
+
+// fills out block index, returns false if block is not allocated
+bool archetype_block(const archetype_t *a, i32 index, archetype_block_t *out);
+
+// runs f over every allocated block in [first, last) in order
+void archetype_run(
+    archetype_t *a,
+    i32 first,
+    i32 last,
+    archetype_system_f f,
+    void *userdata);
+
+// see blklist_save/blklist_restore
+usize archetype_save(const archetype_t *a, void *dst);
+usize archetype_restore(archetype_t *a, const void *src);
+
+// number of entities
+#define archetype_size(_a) ((_a)->list.size)
+
+// get pointer to column of entity at index
+#define archetype_ptr(_T, _a, _c, _i) ((_T*) archetype_ptr_voidp((_a), (_c), (_i)))
+
+// get column array of block
+#define archetype_column(_T, _b, _c) ((_T*) (_b)->columns[(_c)])
+
+// true if slot i of block is present
+#define archetype_block_present(_b, _i) (bitmap_get((_b)->bits, (_i)))
+
+// usage: archetype_each(<archetype>, <i32 index name>) { ... }
+// removing the current entity while iterating is allowed
+#define archetype_each(_a, _i)                                                \
+    for (i32 _i = blklist_next_index(&(_a)->list, -1);                        \
+         _i != -1;                                                            \
+         _i = blklist_next_index(&(_a)->list, _i))
+
+#ifdef UTIL_IMPL
+#include "assert.h"
+#include "math.h"
+
+void archetype_init(
+    archetype_t *a,
+    allocator_t *al,
+    int block_size,
+    int n_columns,
+    const usize *column_sizes) {
+    ASSERT(n_columns > 0 && n_columns <= ARCHETYPE_MAX_COLUMNS);
+    ASSERT(block_size % MAX_ALIGN == 0);
+
+    *a = (archetype_t) { .n_columns = n_columns };
+
+    usize t_size = 0;
+    for (int i = 0; i < n_columns; i++) {
+        a->column_size[i] = column_sizes[i];
+        a->column_offset[i] = t_size * block_size;
+        t_size += column_sizes[i];
+    }
+
+    blklist_init(&a->list, al, block_size, t_size);
+}
+
+void archetype_destroy(archetype_t *a) {
+    blklist_destroy(&a->list);
+    *a = (archetype_t) { 0 };
+}
+
+void archetype_clear(archetype_t *a) {
+    blklist_clear(&a->list);
+}
+
+i32 archetype_add(archetype_t *a) {
+    return blklist_add_index(&a->list);
+}
+
+void archetype_remove(archetype_t *a, i32 index) {
+    blklist_remove(&a->list, index);
+}
+
+bool archetype_present(const archetype_t *a, i32 index) {
+    return blklist_present(&a->list, index);
+}
+
+void *archetype_ptr_voidp(const archetype_t *a, int column, i32 index) {
+    ASSERT(column >= 0 && column < a->n_columns);
+    ASSERT(blklist_present(&a->list, index));
+
+    const i32 block_size = a->list.block_size;
+    u8 *data = blklist_block_data(&a->list, index / block_size);
+    return
+        &data[a->column_offset[column]
+            + ((index % block_size) * a->column_size[column])];
+}
+
+i32 archetype_block_count(const archetype_t *a) {
+    return blklist_block_count(&a->list);
+}
+
+bool archetype_block(const archetype_t *a, i32 index, archetype_block_t *out) {
+    u8 *data = blklist_block_data(&a->list, index);
+    if (!data) { return false; }
+
+    *out = (archetype_block_t) {
+        .index = index,
+        .base = index * a->list.block_size,
+        .size = a->list.block_size,
+        .bits = blklist_block_bitmap(&a->list, index),
+    };
+
+    for (int i = 0; i < a->n_columns; i++) {
+        out->columns[i] = &data[a->column_offset[i]];
+    }
+
+    return true;
+}
+
+void archetype_run(
+    archetype_t *a,
+    i32 first,
+    i32 last,
+    archetype_system_f f,
+    void *userdata) {
+    last = min(last, archetype_block_count(a));
+
+    archetype_block_t block;
+    for (i32 i = first; i < last; i++) {
+        if (archetype_block(a, i, &block)) {
+            f(a, &block, userdata);
+        }
+    }
+}
+
+usize archetype_save(const archetype_t *a, void *dst) {
+    return blklist_save(&a->list, dst);
+}
+
+usize archetype_restore(archetype_t *a, const void *src) {
+    return blklist_restore(&a->list, src);
+}
+
+#endif // ifdef UTIL_IMPL
@@ -4,6 +4,7 @@
 #include "types.h"
 #include "macros.h"
 #include "alloc.h"
+#include "mem.h"
 
 // implements blklist_t, a list which only supports "add at any index" and
 // "remove at specific index" ops but maintains pointer AND index stability by
@@ -42,6 +43,9 @@ void blklist_clear(blklist_t *bl);
 // add into list at any index, returns pointer to allocated space
 void *blklist_add_voidp(blklist_t *bl);
 
+// add into list at any index, returns index of allocated space
+i32 blklist_add_index(blklist_t *bl);
+
 // removes from list at index
 void blklist_remove(blklist_t *bl, i32 index);
 
@@ -60,10 +64,30 @@ void *blklist_ptr_voidp_unsafe(const blklist_t *bl, i32 index);
 // get pointer to element at index IF it is present, otherwise return NULL
 void *blklist_try_ptr_voidp(const blklist_t *bl, i32 index);
 
+// number of block slots, blocks are indices [0, n) and hold elements
+// [block * block_size, (block + 1) * block_size)
+i32 blklist_block_count(const blklist_t *bl);
+
+// presence bitmap of block, NULL if block is not allocated
+const bitmap_t *blklist_block_bitmap(const blklist_t *bl, i32 block);
+
+// raw data (t_size * block_size bytes) of block, NULL if block is not
+// allocated
+void *blklist_block_data(const blklist_t *bl, i32 block);
+
 // gets next valid index for list after i, -1 if no such index
 // pass i == -1 to get the first valid index
 i32 blklist_next_index(const blklist_t *bl, i32 i);
 
+// copies list contents into dst, which must have room for
+// blklist_save(bl, NULL) bytes. returns number of bytes written
+usize blklist_save(const blklist_t *bl, void *dst);
+
+// restores list contents from src written by blklist_save on a list with the
+// same element/block size. every element comes back at the index it was saved
+// at and existing blocks are reused. returns number of bytes read
+usize blklist_restore(blklist_t *bl, const void *src);
+
 // get memory footpri32 of list in bytes
 usize blklist_footprint(const blklist_t *bl);
 
@@ -181,7 +205,25 @@ M_INLINE void *block_data(const blklist_t *bl, blklist_block_t *block) {
                 MAX_ALIGN)];
 }
 
-void *blklist_add_voidp(blklist_t *bl) {
+// allocate block with zeroed bitmap
+static blklist_block_t *block_alloc(const blklist_t *bl) {
+    // allocate for bitmap + data
+    blklist_block_t *block =
+        mem_alloc(
+            bl->allocator,
+            round_up_to_mult(
+                sizeof(bitmap_t)
+                    + BITMAP_SIZE_TO_BYTES(bl->block_size),
+                MAX_ALIGN)
+                + (bl->t_size * bl->block_size));
+
+    // init and zero bitmap
+    bitmap_init(block_bits(bl, block), NULL, bl->block_size);
+    bitmap_fill(block_bits(bl, block), 0);
+    return block;
+}
+
+static void *add_impl(blklist_t *bl, i32 *index) {
     blklist_block_t *block = NULL;
 
     // index of chosen block, internal free index into block
@@ -213,19 +255,7 @@ void *blklist_add_voidp(blklist_t *bl) {
 
     // check if we need to add a block
     if (!block) {
-        // allocate for bitmap + data
-        block =
-            mem_alloc(
-                bl->allocator,
-                round_up_to_mult(
-                    sizeof(bitmap_t)
-                        + BITMAP_SIZE_TO_BYTES(bl->block_size),
-                    MAX_ALIGN)
-                    + (bl->t_size * bl->block_size));
-
-        // init and zero bitmap
-        bitmap_init(block_bits(bl, block), NULL, bl->block_size);
-        bitmap_fill(block_bits(bl, block), 0);
+        block = block_alloc(bl);
 
         // allocate first element
         i = 0;
@@ -263,9 +293,22 @@ void *blklist_add_voidp(blklist_t *bl) {
     ASSERT(!bitmap_get(block_bits(bl, block), i));
     bitmap_set(block_bits(bl, block), i);
     ASSERT(blklist_present(bl, i + (block_index * bl->block_size)));
+
+    *index = i + (block_index * bl->block_size);
     return block_data(bl, block) + ((i % bl->block_size) * bl->t_size);
 }
 
+void *blklist_add_voidp(blklist_t *bl) {
+    i32 index;
+    return add_impl(bl, &index);
+}
+
+i32 blklist_add_index(blklist_t *bl) {
+    i32 index;
+    add_impl(bl, &index);
+    return index;
+}
+
 void blklist_remove(blklist_t *bl, i32 index) {
     ASSERT(index >= 0 && index <= bl->capacity);
 
@@ -368,6 +411,20 @@ void *blklist_try_ptr_voidp(const blklist_t *bl, i32 index) {
     return block_data(bl, block) + ((index % bl->block_size) * bl->t_size);
 }
 
+i32 blklist_block_count(const blklist_t *bl) {
+    return dynlist_size(bl->blocks);
+}
+
+const bitmap_t *blklist_block_bitmap(const blklist_t *bl, i32 block) {
+    ASSERT(block >= 0 && block < dynlist_size(bl->blocks));
+    return bl->blocks[block] ? block_bits(bl, bl->blocks[block]) : NULL;
+}
+
+void *blklist_block_data(const blklist_t *bl, i32 block) {
+    ASSERT(block >= 0 && block < dynlist_size(bl->blocks));
+    return bl->blocks[block] ? block_data(bl, bl->blocks[block]) : NULL;
+}
+
 i32 blklist_next_index(const blklist_t *bl, i32 index) {
     i32 block_index;
 
@@ -420,6 +477,90 @@ find_next:;
     return -1;
 }
 
+// saved layout:
+// * i32 size, capacity, good_block, number of blocks
+// * per block: u8 present, then if present bitmap bytes and t_size * block_size
+//   bytes of data
+usize blklist_save(const blklist_t *bl, void *dst) {
+    const usize
+        n_bits = BITMAP_SIZE_TO_BYTES(bl->block_size),
+        n_data = bl->t_size * bl->block_size;
+
+    u8 *p = dst;
+    usize n = 0;
+
+    const i32 header[4] = {
+        bl->size, bl->capacity, bl->good_block, dynlist_size(bl->blocks)
+    };
+    memput(p, &n, header, sizeof(header));
+
+    dynlist_each(bl->blocks, it) {
+        const u8 present = *it.el != NULL;
+        memput(p, &n, &present, 1);
+
+        if (present) {
+            memput(p, &n, block_bits(bl, *it.el)->bits, n_bits);
+            memput(p, &n, block_data(bl, *it.el), n_data);
+        }
+    }
+
+    return n;
+}
+
+usize blklist_restore(blklist_t *bl, const void *src) {
+    const usize
+        n_bits = BITMAP_SIZE_TO_BYTES(bl->block_size),
+        n_data = bl->t_size * bl->block_size;
+
+    const u8 *p = src;
+
+    i32 header[4];
+    memget(&p, header, sizeof(header));
+
+    const int n_blocks = header[3];
+
+    // drop blocks past the saved ones
+    for (int i = n_blocks; i < dynlist_size(bl->blocks); i++) {
+        if (bl->blocks[i]) {
+            mem_free(bl->allocator, bl->blocks[i]);
+        }
+    }
+
+    const int old_n_blocks = dynlist_size(bl->blocks);
+    dynlist_resize(bl->blocks, n_blocks);
+
+    for (int i = old_n_blocks; i < n_blocks; i++) {
+        bl->blocks[i] = NULL;
+    }
+
+    for (int i = 0; i < n_blocks; i++) {
+        u8 present;
+        memget(&p, &present, 1);
+
+        if (!present) {
+            if (bl->blocks[i]) {
+                mem_free(bl->allocator, bl->blocks[i]);
+                bl->blocks[i] = NULL;
+            }
+
+            continue;
+        }
+
+        if (!bl->blocks[i]) {
+            bl->blocks[i] = block_alloc(bl);
+        }
+
+        memget(&p, block_bits(bl, bl->blocks[i])->bits, n_bits);
+        memget(&p, block_data(bl, bl->blocks[i]), n_data);
+    }
+
+    bl->size = header[0];
+    bl->capacity = header[1];
+    bl->good_block = header[2];
+
+    return p - (const u8*) src;
+}
+
 usize blklist_footprint(const blklist_t *bl) {
     usize n = 0;
     n += dynlist_footprint(bl->blocks);
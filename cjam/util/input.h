@@ -63,7 +63,7 @@ typedef struct {
     u64 time;
 } input_info_t;
 
-// initialize input
+// initialize input, window may be NULL (headless)
 void input_init(input_t*, allocator_t *al, SDL_Window *window);
 
 // deinitialize input
@@ -130,6 +130,12 @@ void input_update(input_t *input, f64 now, v2i window_size, v2i viewport_size) {
     input->cursor.motion_raw = v2i_of(0);
     input->cursor.motion = v2_of(0);
     input->scroll = 0.0f;
+
+    // no window in headless mode, nothing to grab
+    if (!input->window) {
+        return;
+    }
+
     SDL_SetWindowMouseGrab(
         input->window, input->cursor.grab ? SDL_TRUE : SDL_FALSE);
     SDL_ShowCursor(input->cursor.grab ? SDL_FALSE : SDL_TRUE);
@@ -44,7 +44,12 @@ void _log(
     FILE *fp = !strcmp(prefix, "LOG") ? stdout : stderr;
     fprintf(fp, "[%s][%s:%d][%s] ", prefix, file, line, function);
 
-    const int len = vsnprintf(NULL, 0, fmt, ap);
+    // ap cannot be reused after being consumed on all platforms (x86_64)
+    va_list ap_len;
+    va_copy(ap_len, ap);
+    const int len = vsnprintf(NULL, 0, fmt, ap_len);
+    va_end(ap_len);
+
     char buf[len + 1];
     vsnprintf(buf, len + 1, fmt, ap);
     fprintf(fp, "%s%s", buf, buf[len] == '\n' ? "" : "\n");
@@ -67,3 +67,17 @@ M_INLINE void memswap(void *a_, void *b_, usize n) {
         }
     }
 }
+
+// appends n bytes from src to dst at offset *offset and advances it. dst may be
+// NULL to only measure, for save functions which are first called to size
+// their buffer (see blklist_save)
+M_INLINE void memput(void *dst, usize *offset, const void *src, usize n) {
+    if (dst && n > 0) { memcpy(((u8*) dst) + *offset, src, n); }
+    *offset += n;
+}
+
+// reads n bytes at *src into dst and advances *src past them
+M_INLINE void memget(const u8 **src, void *dst, usize n) {
+    if (n > 0) { memcpy(dst, *src, n); }
+    *src += n;
+}
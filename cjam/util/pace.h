@@ -0,0 +1,171 @@
+#pragma once
+
+#include "types.h"
+#include "macros.h"
+
+// implements frame_pacer_t, which limits a frame loop to a target rate and
+// keeps statistics on frame times
+//
+// the pacer sleeps until shortly before each frame is due and spins the rest of
+// the way, as sleeps overshoot by an OS dependent amount. it spins for the
+// worst recent overshoot so frames start on time without burning a core.
+// frames are scheduled against fixed deadlines rather than "now + period" so
+// sleep error does not accumulate. a frame which misses its deadline by a whole
+// period resyncs instead of letting the next frames run back to back.
+
+typedef struct {
+    // frames measured
+    u64 n;
+
+    // time between frame starts in ns, running mean/sum of squared deviations
+    // (see frame_pacer_jitter)
+    f64 mean, m2;
+    u64 min, max;
+
+    // frames which started more than half a period after their deadline
+    u64 late;
+
+    // time spent sleeping/spinning in ns
+    u64 sleep_ns, spin_ns;
+} frame_pacer_stats_t;
+
+typedef struct frame_pacer {
+    // ns between frames, 0 if unlimited
+    u64 period;
+
+    // deadline of next frame, 0 if unscheduled
+    u64 next;
+
+    // start of last frame, 0 if none
+    u64 last;
+
+    // how long before a deadline sleeping stops and spinning starts
+    u64 spin;
+
+    frame_pacer_stats_t stats;
+} frame_pacer_t;
+
+// target_hz <= 0 never waits, statistics are still kept
+void frame_pacer_init(frame_pacer_t *fp, f64 target_hz);
+
+// changes target rate, next frame is scheduled from now
+void frame_pacer_set_target(frame_pacer_t *fp, f64 target_hz);
+
+// waits until the next frame is due, returns its start in time_ns()
+u64 frame_pacer_wait(frame_pacer_t *fp);
+
+// forgets the schedule so the next frame runs immediately and is not counted
+// as late, i.e. after the loop has blocked on something else
+void frame_pacer_resync(frame_pacer_t *fp);
+
+// standard deviation of time between frame starts in ns
+f64 frame_pacer_jitter(const frame_pacer_stats_t *stats);
+
+void frame_pacer_reset_stats(frame_pacer_t *fp);
+
+#ifdef UTIL_IMPL
+
+#include "thread.h"
+#include "time.h"
+#include "math.h"
+
+// bounds of frame_pacer_t::spin
+#define FRAME_PACER_SPIN_MIN 100000
+#define FRAME_PACER_SPIN_MAX 4000000
+
+void frame_pacer_init(frame_pacer_t *fp, f64 target_hz) {
+    *fp = (frame_pacer_t) { .spin = 1000000 };
+    frame_pacer_set_target(fp, target_hz);
+    frame_pacer_reset_stats(fp);
+}
+
+void frame_pacer_set_target(frame_pacer_t *fp, f64 target_hz) {
+    fp->period = target_hz > 0.0 ? (u64) SECS_TO_NS(1.0 / target_hz) : 0;
+    fp->next = 0;
+}
+
+// sleeps until roughly deadline - fp->spin, then adapts fp->spin to how late
+// the sleep woke up
+static void frame_pacer_sleep(frame_pacer_t *fp, u64 deadline) {
+    const u64 start = time_ns();
+    if (start + fp->spin >= deadline) { return; }
+
+    const u64 wake = deadline - fp->spin, ns = wake - start;
+    thrd_sleep(
+        &(struct timespec) {
+            .tv_sec = ns / 1000000000,
+            .tv_nsec = ns % 1000000000,
+        },
+        NULL);
+
+    const u64 end = time_ns();
+    fp->stats.sleep_ns += end - start;
+
+    // grow to the worst overshoot immediately, shrink back slowly
+    const u64 over = end > wake ? end - wake : 0;
+    if (over > fp->spin) {
+        fp->spin = over;
+    } else {
+        fp->spin -= (fp->spin - over) / 64;
+    }
+
+    fp->spin = clamp(fp->spin, FRAME_PACER_SPIN_MIN, FRAME_PACER_SPIN_MAX);
+}
+
+u64 frame_pacer_wait(frame_pacer_t *fp) {
+    u64 now = time_ns();
+
+    if (fp->period != 0) {
+        if (fp->next == 0) {
+            fp->next = now;
+        }
+
+        if (now < fp->next) {
+            frame_pacer_sleep(fp, fp->next);
+
+            const u64 spin_start = time_ns();
+            while ((now = time_ns()) < fp->next) {
+                thrd_yield();
+            }
+            fp->stats.spin_ns += now - spin_start;
+        } else if (now - fp->next > fp->period / 2) {
+            fp->stats.late++;
+        }
+
+        // resync after falling a whole period behind
+        fp->next =
+            now - fp->next >= fp->period ?
+                now + fp->period
+                : fp->next + fp->period;
+    }
+
+    if (fp->last != 0) {
+        const u64 dt = now - fp->last;
+        frame_pacer_stats_t *s = &fp->stats;
+
+        s->n++;
+        const f64 d = dt - s->mean;
+        s->mean += d / s->n;
+        s->m2 += d * (dt - s->mean);
+        s->min = min(s->min, dt);
+        s->max = max(s->max, dt);
+    }
+
+    fp->last = now;
+    return now;
+}
+
+void frame_pacer_resync(frame_pacer_t *fp) {
+    fp->next = 0;
+    fp->last = 0;
+}
+
+f64 frame_pacer_jitter(const frame_pacer_stats_t *stats) {
+    return stats->n > 1 ? sqrt(stats->m2 / (stats->n - 1)) : 0.0;
+}
+
+void frame_pacer_reset_stats(frame_pacer_t *fp) {
+    fp->stats = (frame_pacer_stats_t) { .min = U64_MAX };
+}
+
+#endif // ifdef UTIL_IMPL
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "types.h"
+#include "macros.h"
+#include "math.h"
+#include "alloc.h"
+#include "dynlist.h"
+#include "spatial.h"
+
+// implements pick_index_t, "topmost box under a point" queries over boxes keyed
+// by small non-negative integer ids (i.e. blklist indices)
+//
+// boxes are hashed by their centers into a spatial_hash_t, which callers can
+// query directly as a broadphase for the same ids (see pick_index_t::hash). a
+// point query only visits cells within the largest box half extent seen since
+// the last clear, so boxes should be of similar size.
+//
+// "topmost" follows sprite_t z: lower z is drawn on top. ties go to the lowest
+// id, which matches scanning ids in order and taking the first hit.
+
+typedef struct {
+    boxf_t box;
+    f32 z;
+} pick_entry_t;
+
+typedef struct pick_index {
+    // keyed by box centers, do not modify directly
+    spatial_hash_t hash;
+
+    // indexed by id, junk where id is not present in hash
+    DYNLIST(pick_entry_t) entries;
+
+    // largest half box size set since last clear
+    v2 max_half;
+} pick_index_t;
+
+// initializes a pick index, see spatial_hash_init
+void pick_index_init(
+    pick_index_t *pi,
+    allocator_t *al,
+    f32 cell_size,
+    int n_buckets);
+
+void pick_index_destroy(pick_index_t *pi);
+
+void pick_index_clear(pick_index_t *pi);
+
+// inserts id or moves it to box at depth z. only touches the hash if the
+// center of box has changed cell
+void pick_index_set(pick_index_t *pi, i32 id, boxf_t box, f32 z);
+
+// remove id, must be present
+void pick_index_remove(pick_index_t *pi, i32 id);
+
+// true if id is present
+bool pick_index_present(const pick_index_t *pi, i32 id);
+
+// id of the topmost box containing pos, -1 if there is none
+i32 pick_index_top(const pick_index_t *pi, v2 pos);
+
+// number of ids present
+#define pick_index_size(_pi) ((_pi)->hash.size)
+
+#ifdef UTIL_IMPL
+
+#include "assert.h"
+
+void pick_index_init(
+    pick_index_t *pi,
+    allocator_t *al,
+    f32 cell_size,
+    int n_buckets) {
+    *pi = (pick_index_t) {
+        .entries = dynlist_create(pick_entry_t, al),
+        .max_half = v2_of(0),
+    };
+
+    spatial_hash_init(&pi->hash, al, cell_size, n_buckets);
+}
+
+void pick_index_destroy(pick_index_t *pi) {
+    spatial_hash_destroy(&pi->hash);
+    dynlist_destroy(pi->entries);
+    *pi = (pick_index_t) { 0 };
+}
+
+void pick_index_clear(pick_index_t *pi) {
+    spatial_hash_clear(&pi->hash);
+    dynlist_resize_no_contract(pi->entries, 0);
+    pi->max_half = v2_of(0);
+}
+
+void pick_index_set(pick_index_t *pi, i32 id, boxf_t box, f32 z) {
+    ASSERT(id >= 0);
+
+    if (id >= dynlist_size(pi->entries)) {
+        dynlist_resize_no_contract(pi->entries, id + 1);
+    }
+
+    pi->entries[id] = (pick_entry_t) { .box = box, .z = z };
+    pi->max_half = v2_maxv(pi->max_half, v2_scale(boxf_size(box), 0.5f));
+
+    const v2 center = boxf_center(box);
+    if (spatial_hash_present(&pi->hash, id)) {
+        spatial_hash_update(&pi->hash, id, center);
+    } else {
+        spatial_hash_insert(&pi->hash, id, center);
+    }
+}
+
+void pick_index_remove(pick_index_t *pi, i32 id) {
+    spatial_hash_remove(&pi->hash, id);
+}
+
+bool pick_index_present(const pick_index_t *pi, i32 id) {
+    return spatial_hash_present(&pi->hash, id);
+}
+
+i32 pick_index_top(const pick_index_t *pi, v2 pos) {
+    const spatial_hash_t *sh = &pi->hash;
+
+    // any box containing pos has its center within max_half of pos, pad by a
+    // unit so centers rounded onto a cell boundary are not missed
+    const v2 reach = v2_add(pi->max_half, v2_of(1.0f));
+    const v2i
+        cmin = spatial_hash_cell(sh, v2_sub(pos, reach)),
+        cmax = spatial_hash_cell(sh, v2_add(pos, reach));
+
+    i32 top = -1;
+    f32 top_z = 0.0f;
+
+    for (int y = cmin.y; y <= cmax.y; y++) {
+        for (int x = cmin.x; x <= cmax.x; x++) {
+            const v2i cell = v2i_of(x, y);
+
+            i32 id = sh->buckets[spatial_hash_bucket(sh, cell)];
+            while (id != -1) {
+                const spatial_hash_entry_t *e = &sh->entries[id];
+                const pick_entry_t *p = &pi->entries[id];
+
+                if (v2i_eqv(e->cell, cell)
+                    && boxf_contains(p->box, pos)
+                    && (top == -1
+                        || p->z < top_z
+                        || (p->z == top_z && id < top))) {
+                    top = id;
+                    top_z = p->z;
+                }
+
+                id = e->next;
+            }
+        }
+    }
+
+    return top;
+}
+
+#endif // ifdef UTIL_IMPL
@@ -35,6 +35,10 @@ f32 rand_f32(rand_t *prand, f32 min, f32 max);
 // random chance (0.0..1.0) returns true
 f32 rand_chance(rand_t *prand, f32 p);
 
+// exponentially distributed with mean 1 / rate, i.e. time between events of a
+// poisson process with rate events per unit time
+f64 rand_exp(rand_t *prand, f64 rate);
+
 v2 rand_v2(rand_t *prand, v2 mi, v2 ma);
 
 v3 rand_v3(rand_t *prand, v3 mi, v3 ma);
@@ -126,6 +130,11 @@ f32 rand_chance(rand_t *prand, f32 p) {
     return rand_f32(prand, 0.0f, 1.0f) <= p;
 }
 
+f64 rand_exp(rand_t *prand, f64 rate) {
+    // rand_f64 is in [0, 1) so log never sees 0
+    return -log(1.0 - rand_f64(prand, 0.0, 1.0)) / rate;
+}
+
 v2 rand_v2(rand_t *prand, v2 mi, v2 ma) {
     return
         v2_of(
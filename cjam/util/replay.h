@@ -0,0 +1,354 @@
+#pragma once
+
+#include "types.h"
+#include "macros.h"
+#include "alloc.h"
+#include "dynlist.h"
+#include "math.h"
+
+typedef union SDL_Event SDL_Event;
+
+// implements replay_t, a compact binary log of per-frame input which can be
+// fed back to reproduce a session exactly
+//
+// a log is a header followed by tagged records. every frame starts with a
+// REPLAY_TAG_FRAME record (tick it started on, input time, frame delta, window
+// size) followed by the input events processed that frame and any RNG seeds
+// drawn during it. only the SDL_Event fields read by input_process are stored.
+// values are stored in host byte order, logs are not meant to be portable
+// across architectures.
+
+#define REPLAY_MAGIC 0x504C5952 // 'RPLY'
+#define REPLAY_VERSION 1
+
+typedef enum {
+    REPLAY_NONE = 0,
+    REPLAY_RECORD,
+    REPLAY_PLAY,
+} replay_mode_e;
+
+typedef enum {
+    REPLAY_TAG_FRAME = 1,
+    REPLAY_TAG_MOTION,
+    REPLAY_TAG_WHEEL,
+    REPLAY_TAG_KEY,
+    REPLAY_TAG_BUTTON,
+    REPLAY_TAG_SEED,
+} replay_tag_e;
+
+typedef struct {
+    // g->time.ticks (or equivalent) when the frame started
+    u64 tick;
+
+    // time passed to input_update
+    u64 now;
+
+    // real time since last frame
+    u64 delta_ns;
+
+    v2i window_size;
+} replay_frame_t;
+
+typedef struct replay {
+    allocator_t *allocator;
+
+    replay_mode_e mode;
+
+    // recording is written here on replay_destroy
+    char *path;
+
+    DYNLIST(u8) data;
+
+    // read offset into data (REPLAY_PLAY)
+    int cursor;
+
+    // events/seeds of the frame last returned by replay_next_frame
+    DYNLIST(SDL_Event) events;
+    DYNLIST(u64) seeds;
+    int seed_index;
+
+    // number of frames recorded/played
+    u64 frames;
+} replay_t;
+
+// start recording to path, written out by replay_destroy
+void replay_init_record(replay_t *r, allocator_t *al, const char *path);
+
+// load recording at path for playback, returns nonzero on failure
+int replay_init_play(replay_t *r, allocator_t *al, const char *path);
+
+// destroys replay, writing it to disk if recording
+void replay_destroy(replay_t *r);
+
+// begin a new frame (REPLAY_RECORD only)
+void replay_record_frame(replay_t *r, const replay_frame_t *frame);
+
+// record event passed to input_process, ignored if input doesn't care about it
+// (REPLAY_RECORD only)
+void replay_record_event(replay_t *r, const SDL_Event *ev);
+
+// pass a freshly drawn RNG seed through the replay: records it when recording,
+// returns the recorded seed when playing and returns it unchanged otherwise
+u64 replay_seed(replay_t *r, u64 seed);
+
+// reads the next frame, its events are then in r->events. returns false at
+// end of recording (REPLAY_PLAY only)
+bool replay_next_frame(replay_t *r, replay_frame_t *frame);
+
+#ifdef UTIL_IMPL
+
+#include <SDL2/SDL.h>
+
+#include "assert.h"
+#include "file.h"
+#include "log.h"
+
+M_INLINE void replay_write(replay_t *r, const void *p, int n) {
+    const int offset = dynlist_size(r->data);
+    dynlist_resize_no_contract(r->data, offset + n);
+    memcpy(&r->data[offset], p, n);
+}
+
+M_INLINE bool replay_read(replay_t *r, void *p, int n) {
+    if (r->cursor + n > dynlist_size(r->data)) { return false; }
+    memcpy(p, &r->data[r->cursor], n);
+    r->cursor += n;
+    return true;
+}
+
+#define replay_write_val(_r, _v) ({                                            \
+        typeof(_v) __v = (_v);                                                 \
+        replay_write((_r), &__v, sizeof(__v));                                 \
+    })
+
+#define replay_read_val(_r, _p) (replay_read((_r), (_p), sizeof(*(_p))))
+
+static void replay_init(
+    replay_t *r,
+    allocator_t *al,
+    replay_mode_e mode,
+    const char *path) {
+    *r = (replay_t) {
+        .allocator = al,
+        .mode = mode,
+        .path = mem_strdup(al, path),
+        .data = dynlist_create(u8, al),
+        .events = dynlist_create(SDL_Event, al),
+        .seeds = dynlist_create(u64, al),
+    };
+}
+
+void replay_init_record(replay_t *r, allocator_t *al, const char *path) {
+    replay_init(r, al, REPLAY_RECORD, path);
+    replay_write_val(r, (u32) REPLAY_MAGIC);
+    replay_write_val(r, (u32) REPLAY_VERSION);
+}
+
+int replay_init_play(replay_t *r, allocator_t *al, const char *path) {
+    replay_init(r, al, REPLAY_PLAY, path);
+
+    u8 *data;
+    usize size;
+    int res;
+    if ((res = file_read(path, &data, &size, al))) {
+        WARN("could not read replay %s (%d)", path, res);
+        goto fail;
+    }
+
+    dynlist_resize(r->data, size);
+    memcpy(r->data, data, size);
+    mem_free(al, data);
+
+    u32 magic, version;
+    if (!replay_read_val(r, &magic)
+        || !replay_read_val(r, &version)
+        || magic != REPLAY_MAGIC
+        || version != REPLAY_VERSION) {
+        WARN("%s is not a version %d replay", path, REPLAY_VERSION);
+        res = -1;
+        goto fail;
+    }
+
+    return 0;
+fail:
+    replay_destroy(r);
+    return res;
+}
+
+void replay_destroy(replay_t *r) {
+    if (r->mode == REPLAY_RECORD) {
+        if (file_write(r->path, r->data, dynlist_size(r->data))) {
+            WARN("could not write replay %s", r->path);
+        } else {
+            LOG("wrote %" PRIu64 " frames to %s", r->frames, r->path);
+        }
+    }
+
+    if (r->mode != REPLAY_NONE) {
+        mem_free(r->allocator, r->path);
+        dynlist_destroy(r->data);
+        dynlist_destroy(r->events);
+        dynlist_destroy(r->seeds);
+    }
+
+    *r = (replay_t) { 0 };
+}
+
+void replay_record_frame(replay_t *r, const replay_frame_t *frame) {
+    ASSERT(r->mode == REPLAY_RECORD);
+    replay_write_val(r, (u8) REPLAY_TAG_FRAME);
+    replay_write_val(r, frame->tick);
+    replay_write_val(r, frame->now);
+    replay_write_val(r, frame->delta_ns);
+    replay_write_val(r, (i16) frame->window_size.x);
+    replay_write_val(r, (i16) frame->window_size.y);
+    r->frames++;
+}
+
+void replay_record_event(replay_t *r, const SDL_Event *ev) {
+    ASSERT(r->mode == REPLAY_RECORD);
+
+    switch (ev->type) {
+    case SDL_MOUSEMOTION:
+        replay_write_val(r, (u8) REPLAY_TAG_MOTION);
+        replay_write_val(r, (i16) ev->motion.x);
+        replay_write_val(r, (i16) ev->motion.y);
+        replay_write_val(r, (i16) ev->motion.xrel);
+        replay_write_val(r, (i16) ev->motion.yrel);
+        break;
+    case SDL_MOUSEWHEEL:
+        replay_write_val(r, (u8) REPLAY_TAG_WHEEL);
+        replay_write_val(r, (f32) ev->wheel.preciseY);
+        break;
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        replay_write_val(r, (u8) REPLAY_TAG_KEY);
+        replay_write_val(r, (u8) (ev->type == SDL_KEYDOWN));
+        replay_write_val(r, (u8) ev->key.repeat);
+        replay_write_val(r, (i32) ev->key.keysym.sym);
+        replay_write_val(r, (u16) ev->key.keysym.mod);
+        break;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        replay_write_val(r, (u8) REPLAY_TAG_BUTTON);
+        replay_write_val(r, (u8) (ev->type == SDL_MOUSEBUTTONDOWN));
+        replay_write_val(r, (u8) ev->button.button);
+        break;
+    }
+}
+
+u64 replay_seed(replay_t *r, u64 seed) {
+    switch (r->mode) {
+    case REPLAY_NONE:
+        return seed;
+    case REPLAY_RECORD:
+        replay_write_val(r, (u8) REPLAY_TAG_SEED);
+        replay_write_val(r, seed);
+        return seed;
+    case REPLAY_PLAY:
+        if (r->seed_index >= dynlist_size(r->seeds)) {
+            // fixed fallback so a desynced playback is at least repeatable
+            WARN("replay desync: no recorded seed on frame %" PRIu64, r->frames);
+            return 0x12345;
+        }
+
+        return r->seeds[r->seed_index++];
+    }
+
+    return seed;
+}
+
+bool replay_next_frame(replay_t *r, replay_frame_t *frame) {
+    ASSERT(r->mode == REPLAY_PLAY);
+
+    dynlist_resize_no_contract(r->events, 0);
+    dynlist_resize_no_contract(r->seeds, 0);
+    r->seed_index = 0;
+
+    u8 tag;
+    i16 w, h;
+    if (!replay_read_val(r, &tag)
+        || tag != REPLAY_TAG_FRAME
+        || !replay_read_val(r, &frame->tick)
+        || !replay_read_val(r, &frame->now)
+        || !replay_read_val(r, &frame->delta_ns)
+        || !replay_read_val(r, &w)
+        || !replay_read_val(r, &h)) {
+        return false;
+    }
+
+    frame->window_size = v2i_of(w, h);
+
+    // read up to next frame
+    while (replay_read_val(r, &tag)) {
+        if (tag == REPLAY_TAG_FRAME) {
+            r->cursor--;
+            break;
+        }
+
+        bool ok = true;
+
+        if (tag == REPLAY_TAG_SEED) {
+            if (!replay_read_val(r, dynlist_push(r->seeds))) {
+                WARN("truncated replay");
+                return false;
+            }
+
+            continue;
+        }
+
+        SDL_Event *ev = dynlist_push(r->events);
+        *ev = (SDL_Event) { 0 };
+
+        switch (tag) {
+        case REPLAY_TAG_MOTION: {
+            i16 x = 0, y = 0, xrel = 0, yrel = 0;
+            ok = replay_read_val(r, &x)
+                && replay_read_val(r, &y)
+                && replay_read_val(r, &xrel)
+                && replay_read_val(r, &yrel);
+            ev->motion.type = SDL_MOUSEMOTION;
+            ev->motion.x = x;
+            ev->motion.y = y;
+            ev->motion.xrel = xrel;
+            ev->motion.yrel = yrel;
+        } break;
+        case REPLAY_TAG_WHEEL:
+            ev->wheel.type = SDL_MOUSEWHEEL;
+            ok = replay_read_val(r, &ev->wheel.preciseY);
+            break;
+        case REPLAY_TAG_KEY: {
+            u8 down = 0, repeat = 0;
+            i32 sym = 0;
+            u16 mod = 0;
+            ok = replay_read_val(r, &down)
+                && replay_read_val(r, &repeat)
+                && replay_read_val(r, &sym)
+                && replay_read_val(r, &mod);
+            ev->key.type = down ? SDL_KEYDOWN : SDL_KEYUP;
+            ev->key.repeat = repeat;
+            ev->key.keysym.sym = sym;
+            ev->key.keysym.mod = mod;
+        } break;
+        case REPLAY_TAG_BUTTON: {
+            u8 down = 0, button = 0;
+            ok = replay_read_val(r, &down) && replay_read_val(r, &button);
+            ev->button.type = down ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+            ev->button.button = button;
+        } break;
+        default:
+            WARN("bad replay tag %d at %d", tag, r->cursor - 1);
+            return false;
+        }
+
+        if (!ok) {
+            WARN("truncated replay");
+            return false;
+        }
+    }
+
+    r->frames++;
+    return true;
+}
+
+#endif // ifdef UTIL_IMPL
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "types.h"
+#include "macros.h"
+
+// 4-wide f32/i32 vectors using compiler vector extensions, which lower to
+// SSE/NEON/wasm simd128 ops (or scalar code if the target has no SIMD at all).
+// 4-wide is the baseline on every target, wider vectors change the calling
+// convention of these helpers unless AVX is enabled.
+//
+// comparisons produce i32x4 lane masks (~0 for true, 0 for false), f32x4 <->
+// i32x4 casts are bitcasts. loads/stores are unaligned.
+
+#define SIMD_LANES 4
+
+typedef f32 f32x4 __attribute__((vector_size(SIMD_LANES * sizeof(f32))));
+typedef i32 i32x4 __attribute__((vector_size(SIMD_LANES * sizeof(i32))));
+
+M_INLINE f32x4 f32x4_load(const f32 *p) {
+    f32x4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+M_INLINE void f32x4_store(f32 *p, f32x4 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+M_INLINE i32x4 i32x4_load(const i32 *p) {
+    i32x4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+M_INLINE void i32x4_store(i32 *p, i32x4 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+M_INLINE f32x4 f32x4_splat(f32 x) {
+    return (f32x4) { x, x, x, x };
+}
+
+// per lane m ? a : b
+M_INLINE f32x4 f32x4_select(i32x4 m, f32x4 a, f32x4 b) {
+    return (f32x4) ((m & (i32x4) a) | (~m & (i32x4) b));
+}
+
+M_INLINE f32x4 f32x4_min(f32x4 a, f32x4 b) {
+    return f32x4_select(a < b, a, b);
+}
+
+M_INLINE f32x4 f32x4_max(f32x4 a, f32x4 b) {
+    return f32x4_select(a > b, a, b);
+}
+
+M_INLINE f32x4 f32x4_clamp(f32x4 x, f32x4 lo, f32x4 hi) {
+    return f32x4_min(f32x4_max(x, lo), hi);
+}
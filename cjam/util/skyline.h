@@ -0,0 +1,164 @@
+#pragma once
+
+#include "types.h"
+#include "macros.h"
+#include "math.h"
+#include "alloc.h"
+#include "dynlist.h"
+
+// implements skyline_t, a rectangle packer for building texture atlases
+//
+// the packed area is tracked as its top edge (the "skyline"), a list of
+// horizontal segments ordered by x. each rectangle goes wherever its top ends
+// lowest (bottom-left heuristic, ties go to the leftmost position), and space
+// below the skyline which a rectangle overhangs is lost. this wastes a little
+// more space than maxrects but inserts in O(segments) with no free list: the
+// height a rectangle sits at is the max over the segments it spans, which is
+// kept for every left edge at once by a sliding window max (a queue of
+// segment indices with decreasing y) as the window moves right.
+
+typedef struct {
+    i32 x, y, w;
+} skyline_segment_t;
+
+typedef struct skyline {
+    v2i size;
+
+    // ordered by x, covering [0, size.x)
+    DYNLIST(skyline_segment_t) segments;
+
+    // scratch for skyline_insert, indices into segments
+    DYNLIST(int) queue;
+
+    // area of all inserted rectangles
+    i64 used;
+} skyline_t;
+
+void skyline_init(skyline_t *s, allocator_t *al, v2i size);
+
+void skyline_destroy(skyline_t *s);
+
+void skyline_clear(skyline_t *s);
+
+// places a rectangle of size, returns false if it does not fit
+bool skyline_insert(skyline_t *s, v2i size, v2i *pos);
+
+// fraction of area used by inserted rectangles
+f32 skyline_occupancy(const skyline_t *s);
+
+#ifdef UTIL_IMPL
+
+void skyline_init(skyline_t *s, allocator_t *al, v2i size) {
+    *s = (skyline_t) {
+        .size = size,
+        .segments = dynlist_create(skyline_segment_t, al),
+        .queue = dynlist_create(int, al),
+    };
+
+    skyline_clear(s);
+}
+
+void skyline_destroy(skyline_t *s) {
+    dynlist_destroy(s->segments);
+    dynlist_destroy(s->queue);
+    *s = (skyline_t) { 0 };
+}
+
+void skyline_clear(skyline_t *s) {
+    dynlist_resize_no_contract(s->segments, 0);
+    *dynlist_push(s->segments) =
+        (skyline_segment_t) { .x = 0, .y = 0, .w = s->size.x };
+    s->used = 0;
+}
+
+bool skyline_insert(skyline_t *s, v2i size, v2i *pos) {
+    if (size.x <= 0 || size.y <= 0) { return false; }
+
+    const int n = dynlist_size(s->segments);
+
+    int best = -1;
+    i32 best_y = 0;
+
+    // segments [i, j) span the rectangle with its left edge on segment i, the
+    // queue holds indices of [i, j) whose y is higher than every later one's so
+    // its head is the highest
+    dynlist_resize_no_contract(s->queue, 0);
+    int head = 0, j = 0;
+    i32 covered = 0;
+
+    for (int i = 0; i < n; i++) {
+        const i32 x = s->segments[i].x;
+        if (x + size.x > s->size.x) { break; }
+
+        while (covered < size.x) {
+            while (dynlist_size(s->queue) > head
+                && s->segments[s->queue[dynlist_size(s->queue) - 1]].y
+                    <= s->segments[j].y) {
+                dynlist_remove_no_realloc(
+                    s->queue, dynlist_size(s->queue) - 1);
+            }
+
+            *dynlist_push(s->queue) = j;
+            covered += s->segments[j].w;
+            j++;
+        }
+
+        while (s->queue[head] < i) { head++; }
+
+        const i32 y = s->segments[s->queue[head]].y;
+
+        if (y + size.y <= s->size.y && (best == -1 || y < best_y)) {
+            best = i;
+            best_y = y;
+        }
+
+        covered -= s->segments[i].w;
+    }
+
+    if (best == -1) { return false; }
+
+    const i32 x = s->segments[best].x, right = x + size.x;
+
+    // new segment for the top of the rectangle, then shrink or drop the
+    // segments it covers
+    *dynlist_insert(s->segments, best) =
+        (skyline_segment_t) { .x = x, .y = best_y + size.y, .w = size.x };
+
+    int i = best + 1;
+    while (i < dynlist_size(s->segments)) {
+        skyline_segment_t *seg = &s->segments[i];
+        if (seg->x >= right) { break; }
+
+        const i32 seg_right = seg->x + seg->w;
+        if (seg_right <= right) {
+            dynlist_remove_no_realloc(s->segments, i);
+            continue;
+        }
+
+        seg->w = seg_right - right;
+        seg->x = right;
+        break;
+    }
+
+    // merge neighbours at the same height
+    for (i = 0; i + 1 < dynlist_size(s->segments);) {
+        skyline_segment_t *a = &s->segments[i], *b = &s->segments[i + 1];
+
+        if (a->y == b->y) {
+            a->w += b->w;
+            dynlist_remove_no_realloc(s->segments, i + 1);
+        } else {
+            i++;
+        }
+    }
+
+    s->used += (i64) size.x * size.y;
+    *pos = v2i_of(x, best_y);
+    return true;
+}
+
+f32 skyline_occupancy(const skyline_t *s) {
+    return (f32) ((f64) s->used / ((f64) s->size.x * s->size.y));
+}
+
+#endif // ifdef UTIL_IMPL
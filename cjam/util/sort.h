@@ -12,9 +12,15 @@ void sort(
     sort_cmp_f cmp,
     void *arg);
 
+// sorts keys ascending with an LSD radix sort, 8 bits per pass. tmp must have
+// room for n keys. passes over bytes which are the same in every key are
+// skipped, so keys which only vary in a few bytes sort in a few passes
+void sort_radix_u64(u64 *keys, usize n, u64 *tmp);
+
 #ifdef UTIL_IMPL
 
 #include <stdlib.h>
+#include <string.h>
 
 typedef struct sort_data {
     void *arg;
@@ -46,4 +52,48 @@ void sort(
 #endif // ifdef TARGET_PLATFORM_macos
 }
 
+void sort_radix_u64(u64 *keys, usize n, u64 *tmp) {
+    if (n < 2) { return; }
+
+    // histograms of every byte in one read
+    usize counts[8][256];
+    memset(counts, 0, sizeof(counts));
+
+    for (usize i = 0; i < n; i++) {
+        const u64 k = keys[i];
+        for (int b = 0; b < 8; b++) {
+            counts[b][(k >> (b * 8)) & 0xFF]++;
+        }
+    }
+
+    u64 *src = keys, *dst = tmp;
+
+    for (int b = 0; b < 8; b++) {
+        const int shift = b * 8;
+
+        // every key has the same byte, nothing moves
+        if (counts[b][(src[0] >> shift) & 0xFF] == n) { continue; }
+
+        usize offsets[256];
+        usize total = 0;
+        for (int d = 0; d < 256; d++) {
+            offsets[d] = total;
+            total += counts[b][d];
+        }
+
+        for (usize i = 0; i < n; i++) {
+            const u64 k = src[i];
+            dst[offsets[(k >> shift) & 0xFF]++] = k;
+        }
+
+        u64 *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != keys) {
+        memcpy(keys, src, n * sizeof(u64));
+    }
+}
+
 #endif // ifdef UTIL_IMPL
@@ -3,9 +3,13 @@
 #include "../util/types.h"
 
 #define SOUND_ID_NONE 0
+#define SOUND_SOURCE_NONE 0
 
 typedef i32 sound_id_t;
 
+// handle to a loaded audio source
+typedef i32 sound_source_t;
+
 typedef struct {
     // 0..1
     f32 volume;
@@ -21,7 +25,18 @@ void sound_destroy();
 // update sound subsystem, mixers, etc.
 void sound_update(f32 dt);
 
-// play sound from filename, returns != SOUND_ID_NONE on success
+// load sound from filename (or find it if it is already loaded), returns
+// != SOUND_SOURCE_NONE on success. the handle stays valid until sound_destroy
+sound_source_t sound_load(const char *filename);
+
+// play loaded sound, no string formatting or hashing. returns != SOUND_ID_NONE
+// on success
+sound_id_t sound_play_source(
+    sound_source_t source,
+    const sound_params_t *params);
+
+// play sound from filename, returns != SOUND_ID_NONE on success. prefer
+// sound_load + sound_play_source for sounds played often
 sound_id_t sound_play(const char *filename, const sound_params_t *params);
 
 // true if id is playing
@@ -39,31 +54,35 @@ bool sound_try_modify(sound_id_t id, const sound_params_t *params);
 #include "../ext/cute_sound.h"
 
 #include "../reloadhost/reloadhost.h"
+#include "../util/dynlist.h"
 #include "../util/log.h"
 #include "../util/map.h"
 
 typedef struct {
     // loaded audio sources
-    // const char* filename -> cs_audio_source_t
+    // const char* filename -> sound_source_t
     map_t sources;
 
+    // sound_source_t -> cs_audio_source_t*, 0 is SOUND_SOURCE_NONE
+    DYNLIST(cs_audio_source_t*) source_list;
+
     // actively playing sounds
     // sound_id_t -> cs_playing_sound_t
     map_t active;
 
     sound_id_t next_sound_id;
+
+    // false if sound_init was never called (headless), all ops are no-ops
+    bool init;
 } snd_t;
 
 static snd_t snd;
 
 RELOAD_STATIC_GLOBAL(snd);
 
-static void map_cs_audio_source_free(map_t*, void *p) {
-    cs_free_audio_source(*(cs_audio_source_t**) p);
-}
-
 bool sound_init() {
     snd.next_sound_id = 1;
+    snd.init = true;
 
     cs_error_t err;
     if ((err = cs_init(NULL, 44100, 1024, NULL)) != CUTE_SOUND_ERROR_NONE) {
@@ -75,13 +94,16 @@ bool sound_init() {
         &snd.sources,
         g_mallocator,
         sizeof(const char*),
-        sizeof(cs_audio_source_t*),
+        sizeof(sound_source_t),
         map_hash_str,
         map_cmp_str,
         map_default_free,
-        map_cs_audio_source_free,
+        NULL,
         NULL);
 
+    snd.source_list = dynlist_create(cs_audio_source_t*, g_mallocator);
+    *dynlist_push(snd.source_list) = NULL;
+
     map_init(
         &snd.active,
         g_mallocator,
@@ -97,12 +119,21 @@ bool sound_init() {
 }
 
 void sound_destroy() {
+    if (!snd.init) { return; }
+
+    dynlist_each(snd.source_list, it) {
+        if (*it.el) { cs_free_audio_source(*it.el); }
+    }
+
     map_destroy(&snd.sources);
     map_destroy(&snd.active);
+    dynlist_destroy(snd.source_list);
     cs_shutdown();
 }
 
 void sound_update(f32 dt) {
+    if (!snd.init) { return; }
+
     cs_update(dt);
 
     DYNLIST(sound_id_t) to_remove =
@@ -119,30 +150,41 @@ void sound_update(f32 dt) {
     }
 }
 
-sound_id_t sound_play(const char *filename, const sound_params_t *params) {
-    cs_audio_source_t **psrc =
-        map_get(cs_audio_source_t*, &snd.sources, &filename);
-
-    cs_audio_source_t *src = NULL;
-
-    if (psrc) {
-        src = *psrc;
-    } else {
-        cs_error_t err;
-        src = cs_load_wav(filename, &err);
-
-        if (err != CUTE_SOUND_ERROR_NONE) {
-            ERROR(
-                "error loading audio from %s: %s",
-                filename,
-                cs_error_as_string(err));
-            return 0;
-        }
+sound_source_t sound_load(const char *filename) {
+    if (!snd.init) { return SOUND_SOURCE_NONE; }
+
+    const sound_source_t *psrc =
+        map_get(sound_source_t, &snd.sources, &filename);
 
-        const char *p = strdup(filename);
-        map_insert(&snd.sources, &p, &src);
+    if (psrc) { return *psrc; }
+
+    cs_error_t err;
+    cs_audio_source_t *src = cs_load_wav(filename, &err);
+
+    if (err != CUTE_SOUND_ERROR_NONE) {
+        ERROR(
+            "error loading audio from %s: %s",
+            filename,
+            cs_error_as_string(err));
+        return SOUND_SOURCE_NONE;
     }
 
+    const sound_source_t source = dynlist_size(snd.source_list);
+    *dynlist_push(snd.source_list) = src;
+
+    const char *p = strdup(filename);
+    map_insert(&snd.sources, &p, &source);
+    return source;
+}
+
+sound_id_t sound_play_source(
+    sound_source_t source,
+    const sound_params_t *params) {
+    if (!snd.init || source == SOUND_SOURCE_NONE) { return SOUND_ID_NONE; }
+
+    ASSERT(source > 0 && source < dynlist_size(snd.source_list));
+    cs_audio_source_t *src = snd.source_list[source];
+
     ASSERT(src);
     const cs_playing_sound_t playing =
         cs_play_sound(
@@ -161,13 +203,21 @@ sound_id_t sound_play(const char *filename, const sound_params_t *params) {
     return id;
 }
 
+sound_id_t sound_play(const char *filename, const sound_params_t *params) {
+    return sound_play_source(sound_load(filename), params);
+}
+
 bool sound_active(sound_id_t id) {
+    if (!snd.init) { return false; }
+
     return map_contains(&snd.active, &id);
 }
 
 bool sound_try_modify(sound_id_t id, const sound_params_t *params) {
     ASSERT(params);
 
+    if (!snd.init) { return false; }
+
     if (params->pan != 0.0f) {
         WARN("cannot modify pan on active sound, ignoring");
     }
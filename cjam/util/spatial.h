@@ -0,0 +1,228 @@
+#pragma once
+
+#include "types.h"
+#include "macros.h"
+#include "math.h"
+#include "alloc.h"
+#include "dynlist.h"
+
+// implements spatial_hash_t, a uniform grid broadphase over points keyed by
+// small non-negative integer ids (i.e. blklist indices)
+//
+// the grid is unbounded: cells are hashed into a fixed power-of-two number of
+// buckets, each of which is an intrusive doubly linked list of entries. entries
+// store their cell so that queries never report false positives from bucket
+// collisions and never report an id twice.
+
+typedef struct {
+    // next/prev entry in bucket, -1 if none
+    i32 next, prev;
+
+    // bucket index, -1 if entry is not present
+    i32 bucket;
+
+    // grid cell
+    v2i cell;
+} spatial_hash_entry_t;
+
+typedef struct spatial_hash {
+    allocator_t *allocator;
+
+    f32 cell_size, inv_cell_size;
+
+    // heads of bucket lists, -1 if empty
+    DYNLIST(i32) buckets;
+
+    // indexed by id
+    DYNLIST(spatial_hash_entry_t) entries;
+
+    int size;
+} spatial_hash_t;
+
+// initializes a spatial hash, n_buckets must be a power of two
+void spatial_hash_init(
+    spatial_hash_t *sh,
+    allocator_t *al,
+    f32 cell_size,
+    int n_buckets);
+
+// destroys a spatial hash
+void spatial_hash_destroy(spatial_hash_t *sh);
+
+// removes all entries from a spatial hash
+void spatial_hash_clear(spatial_hash_t *sh);
+
+// insert id at pos, id must not already be present
+void spatial_hash_insert(spatial_hash_t *sh, i32 id, v2 pos);
+
+// move id to pos, only touches buckets if the cell has changed
+void spatial_hash_update(spatial_hash_t *sh, i32 id, v2 pos);
+
+// remove id, must be present
+void spatial_hash_remove(spatial_hash_t *sh, i32 id);
+
+// true if id is present
+bool spatial_hash_present(const spatial_hash_t *sh, i32 id);
+
+// appends all ids in cells overlapping box to *out, in no particular order
+// caller is responsible for narrowphase
+void spatial_hash_query(
+    const spatial_hash_t *sh,
+    boxf_t box,
+    DYNLIST(i32) *out);
+
+#ifdef UTIL_IMPL
+
+#include "assert.h"
+#include "hash.h"
+
+M_INLINE v2i spatial_hash_cell(const spatial_hash_t *sh, v2 pos) {
+    return
+        v2i_of(
+            (int) floorf(pos.x * sh->inv_cell_size),
+            (int) floorf(pos.y * sh->inv_cell_size));
+}
+
+M_INLINE i32 spatial_hash_bucket(const spatial_hash_t *sh, v2i cell) {
+    return
+        (i32) (hash_add_v2i(0x12345, cell)
+            & (u64) (dynlist_size(sh->buckets) - 1));
+}
+
+M_INLINE void spatial_hash_link(spatial_hash_t *sh, i32 id, v2i cell) {
+    spatial_hash_entry_t *e = &sh->entries[id];
+    const i32 bucket = spatial_hash_bucket(sh, cell);
+
+    e->cell = cell;
+    e->bucket = bucket;
+    e->prev = -1;
+    e->next = sh->buckets[bucket];
+
+    if (e->next != -1) {
+        sh->entries[e->next].prev = id;
+    }
+
+    sh->buckets[bucket] = id;
+}
+
+M_INLINE void spatial_hash_unlink(spatial_hash_t *sh, i32 id) {
+    spatial_hash_entry_t *e = &sh->entries[id];
+
+    if (e->prev != -1) {
+        sh->entries[e->prev].next = e->next;
+    } else {
+        sh->buckets[e->bucket] = e->next;
+    }
+
+    if (e->next != -1) {
+        sh->entries[e->next].prev = e->prev;
+    }
+
+    *e = (spatial_hash_entry_t) { .next = -1, .prev = -1, .bucket = -1 };
+}
+
+void spatial_hash_init(
+    spatial_hash_t *sh,
+    allocator_t *al,
+    f32 cell_size,
+    int n_buckets) {
+    ASSERT(cell_size > 0.0f);
+    ASSERT(n_buckets > 0 && (n_buckets & (n_buckets - 1)) == 0);
+
+    *sh = (spatial_hash_t) {
+        .allocator = al,
+        .cell_size = cell_size,
+        .inv_cell_size = 1.0f / cell_size,
+        .buckets = dynlist_create(i32, al, n_buckets),
+        .entries = dynlist_create(spatial_hash_entry_t, al),
+    };
+
+    dynlist_resize(sh->buckets, n_buckets);
+    memset(sh->buckets, 0xFF, n_buckets * sizeof(i32));
+}
+
+void spatial_hash_destroy(spatial_hash_t *sh) {
+    dynlist_destroy(sh->buckets);
+    dynlist_destroy(sh->entries);
+    *sh = (spatial_hash_t) { 0 };
+}
+
+void spatial_hash_clear(spatial_hash_t *sh) {
+    memset(sh->buckets, 0xFF, dynlist_size(sh->buckets) * sizeof(i32));
+    dynlist_resize_no_contract(sh->entries, 0);
+    sh->size = 0;
+}
+
+void spatial_hash_insert(spatial_hash_t *sh, i32 id, v2 pos) {
+    ASSERT(id >= 0);
+
+    // grow entries to fit id, new entries are not present
+    const int old_size = dynlist_size(sh->entries);
+    if (id >= old_size) {
+        dynlist_resize_no_contract(sh->entries, id + 1);
+
+        for (int i = old_size; i <= id; i++) {
+            sh->entries[i] =
+                (spatial_hash_entry_t) { .next = -1, .prev = -1, .bucket = -1 };
+        }
+    }
+
+    ASSERT(sh->entries[id].bucket == -1, "id %d already present", id);
+    spatial_hash_link(sh, id, spatial_hash_cell(sh, pos));
+    sh->size++;
+}
+
+void spatial_hash_update(spatial_hash_t *sh, i32 id, v2 pos) {
+    ASSERT(spatial_hash_present(sh, id));
+
+    const v2i cell = spatial_hash_cell(sh, pos);
+    if (v2i_eqv(cell, sh->entries[id].cell)) {
+        return;
+    }
+
+    spatial_hash_unlink(sh, id);
+    spatial_hash_link(sh, id, cell);
+}
+
+void spatial_hash_remove(spatial_hash_t *sh, i32 id) {
+    ASSERT(spatial_hash_present(sh, id));
+    spatial_hash_unlink(sh, id);
+    sh->size--;
+}
+
+bool spatial_hash_present(const spatial_hash_t *sh, i32 id) {
+    return
+        id >= 0
+        && id < dynlist_size(sh->entries)
+        && sh->entries[id].bucket != -1;
+}
+
+void spatial_hash_query(
+    const spatial_hash_t *sh,
+    boxf_t box,
+    DYNLIST(i32) *out) {
+    const v2i
+        cmin = spatial_hash_cell(sh, box.min),
+        cmax = spatial_hash_cell(sh, box.max);
+
+    for (int y = cmin.y; y <= cmax.y; y++) {
+        for (int x = cmin.x; x <= cmax.x; x++) {
+            const v2i cell = v2i_of(x, y);
+
+            // entries of other cells may share this bucket, only report those
+            // which are actually in this cell so nothing is reported twice
+            i32 id = sh->buckets[spatial_hash_bucket(sh, cell)];
+            while (id != -1) {
+                const spatial_hash_entry_t *e = &sh->entries[id];
+
+                if (v2i_eqv(e->cell, cell)) {
+                    *dynlist_push(*out) = id;
+                }
+
+                id = e->next;
+            }
+        }
+    }
+}
+
+#endif // ifdef UTIL_IMPL
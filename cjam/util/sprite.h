@@ -45,6 +45,11 @@ typedef struct sprite_instance sprite_instance_t;
 typedef struct sprite_batch {
     const sprite_atlas_t *atlas;
     DYNLIST(sprite_instance_t) sprites;
+
+    // set by sprite_batch_sort, cleared by any push. sprites [0, n_opaque) are
+    // opaque, the rest are translucent
+    bool sorted;
+    int n_opaque;
 } sprite_batch_t;
 
 void sprite_atlas_init(
@@ -71,8 +76,29 @@ void sprite_batch_push_subimage(
     const sprite_t *sprite,
     boxi_t box);
 
+// push n copies of one subimage in a single pass, copy i is at (x[i], y[i])
+// with color[i] and z + (i * z_step)
+void sprite_batch_push_subimages(
+    sprite_batch_t *batch,
+    boxi_t box,
+    int n,
+    const f32 *x,
+    const f32 *y,
+    const v4 *color,
+    f32 z,
+    f32 z_step,
+    int flags);
+
+// sorts batch for drawing: opaque sprites (color alpha 1) first, then
+// translucent sprites, each back to front (descending z) and in push order for
+// equal z. translucent sprites of sorted batches are drawn without depth writes
+// so they blend over everything behind them in order. a batch binds a single
+// atlas so there is no texture to sort on
+void sprite_batch_sort(sprite_batch_t *batch);
+
 // * model is optional
 // * does not clear/destroy batch
+// * draws in push order unless batch has been sorted, see sprite_batch_sort
 void sprite_batch_draw(
     const sprite_batch_t *batch,
     const m4 *model,
@@ -90,6 +116,107 @@ void sprite_draw_direct(
     const m4 *view,
     const m4 *proj);
 
+// instances are uploaded into stream buffers of SPRITE_CHUNK_INSTANCES each,
+// more are created as a frame needs them up to SPRITE_MAX_BUFFERS. draws which
+// do not fit in what is left of a buffer are split into several chunks
+#define SPRITE_CHUNK_INSTANCES 65536
+#define SPRITE_MAX_BUFFERS 64
+
+typedef struct sprite_stats {
+    // instance data uploaded
+    u64 bytes;
+
+    // sg_append_buffer calls, each followed by one instanced draw
+    u64 chunks;
+
+    // instances which did not fit in SPRITE_MAX_BUFFERS and were not drawn
+    u64 dropped;
+
+    // instance buffers created so far
+    int buffers;
+} sprite_stats_t;
+
+// counters since the last sprite_reset_stats
+const sprite_stats_t *sprite_stats();
+
+void sprite_reset_stats();
+
+// an image packed into a page of a sprite_image_atlas_t
+typedef struct sprite_image {
+    sg_image image;
+    boxi_t box;
+} sprite_image_t;
+
+typedef struct sprite_image_page sprite_image_page_t;
+
+// standalone images of any size packed into as few page textures as possible,
+// so that drawing them needs few texture bindings (see sprite_image_batch_t)
+typedef struct sprite_image_atlas {
+    allocator_t *allocator;
+    v2i page_size;
+    DYNLIST(sprite_image_page_t) pages;
+} sprite_image_atlas_t;
+
+// images larger than page_size get a page of their own
+void sprite_image_atlas_init(
+    sprite_image_atlas_t *atlas,
+    allocator_t *a,
+    v2i page_size);
+
+void sprite_image_atlas_destroy(sprite_image_atlas_t *atlas);
+
+// packs size.x * size.y RGBA8 texels, data is copied. the returned image is
+// valid but must not be drawn until sprite_image_atlas_build
+sprite_image_t sprite_image_atlas_add(
+    sprite_image_atlas_t *atlas,
+    const u8 *data,
+    v2i size);
+
+// uploads pages, no images can be added afterwards
+void sprite_image_atlas_build(sprite_image_atlas_t *atlas);
+
+typedef struct sprite_image_draw sprite_image_draw_t;
+
+// deferred sprite_draw_direct calls, which can be of any image
+typedef struct sprite_image_batch {
+    DYNLIST(sprite_image_draw_t) draws;
+} sprite_image_batch_t;
+
+void sprite_image_batch_init(sprite_image_batch_t *batch, allocator_t *a);
+
+void sprite_image_batch_destroy(sprite_image_batch_t *batch);
+
+// see sprite_draw_direct, image must be valid until batch is drawn
+void sprite_image_batch_push(
+    sprite_image_batch_t *batch,
+    sg_image image,
+    const boxi_t *box,
+    v2 pos,
+    f32 z,
+    v4 color,
+    int flags);
+
+// see sprite_image_batch_push
+void sprite_image_batch_push_image(
+    sprite_image_batch_t *batch,
+    const sprite_image_t *image,
+    v2 pos,
+    f32 z,
+    v4 color,
+    int flags);
+
+// * model is optional
+// * does not clear/destroy batch
+// * issues one upload and draw per distinct image, more if it spans instance
+//   buffers (see SPRITE_CHUNK_INSTANCES). draws of the same image keep push
+//   order, draws of different images are only ordered by the depth test so
+//   they should be opaque
+void sprite_image_batch_draw(
+    const sprite_image_batch_t *batch,
+    const m4 *model,
+    const m4 *view,
+    const m4 *proj);
+
 #ifdef UTIL_IMPL
 
 #ifndef SOKOL_GFX_INCLUDED
@@ -107,29 +234,96 @@ void sprite_draw_direct(
 
 #include "../util/dynlist.h"
 #include "../util/image.h"
+#include "../util/skyline.h"
+#include "../util/sort.h"
 
+// per instance vertex data, 24 bytes. must match with shader/sprite.glsl
 typedef struct sprite_instance {
-    v2 offset;
-    v2 scale;
-    v2 uv_min, uv_max;
-    v4 color;
     f32 z;
-    f32 flags; // i32_bits_to_f32
+
+    // position in 1/SPRITE_SUBPIXELS px, SHORT2
+    i16 offset[2];
+
+    // texel min and size, quad size is texel size. SHORT4
+    i16 uv[4];
+
+    // UBYTE4N
+    u8 color[4];
+
+    // { flags, 0, 0, 0 }, UBYTE4
+    u8 flags[4];
 } sprite_instance_t;
 
+STATIC_ASSERT(sizeof(sprite_instance_t) == 24);
+
+typedef struct sprite_image_page {
+    skyline_t skyline;
+
+    // RGBA8, NULL once built
+    u8 *data;
+
+    // allocated on page creation, initialized by sprite_image_atlas_build
+    sg_image image;
+} sprite_image_page_t;
+
+// transparent texels around each image in a page, so filtering or rounding at
+// image edges never picks up a neighbour
+#define SPRITE_IMAGE_ATLAS_PADDING 1
+
+typedef struct sprite_image_draw {
+    sg_image image;
+    sprite_instance_t instance;
+} sprite_image_draw_t;
+
 typedef struct sprite_vertex {
     v2 position;
     v2 texcoord;
 } sprite_vertex_t;
 
-// PER-FRAME limit!
-#define SPRITE_MAX_INSTANCES 65536
+// fractional bits of sprite_instance_t::offset, must match with
+// shader/sprite.glsl
+#define SPRITE_SUBPIXELS 16
+
+// sprite_instance_t for a quad of size texels at pos showing texels
+// [uv_min, uv_min + size)
+M_INLINE sprite_instance_t sprite_instance_pack(
+    v2 pos,
+    f32 z,
+    v2i uv_min,
+    v2i size,
+    v4 color,
+    int flags) {
+    const v2 fixed =
+        v2_clampv(
+            v2_scale(pos, SPRITE_SUBPIXELS),
+            v2_of(I16_MIN),
+            v2_of(I16_MAX));
+
+    return (sprite_instance_t) {
+        .z = z,
+        .offset = { (i16) roundf(fixed.x), (i16) roundf(fixed.y) },
+        .uv = { (i16) uv_min.x, (i16) uv_min.y, (i16) size.x, (i16) size.y },
+        .color = {
+            (u8) roundf(saturate(color.r) * 255.0f),
+            (u8) roundf(saturate(color.g) * 255.0f),
+            (u8) roundf(saturate(color.b) * 255.0f),
+            (u8) roundf(saturate(color.a) * 255.0f),
+        },
+        .flags = { (u8) flags },
+    };
+}
 
 static struct {
     bool init;
-    sg_buffer ibuf, vbuf, instbuf;
+    sg_buffer ibuf, vbuf;
+
+    // created on demand, see sprite_upload
+    sg_buffer instbufs[SPRITE_MAX_BUFFERS];
+    int n_instbufs;
+
+    sprite_stats_t stats;
     sg_shader shd;
-    sg_pipeline pip;
+    sg_pipeline pip, pip_blend;
     sg_sampler smp;
 } _sprite;
 
@@ -175,86 +369,75 @@ static void sprite_lazy_init() {
                 .data = SG_RANGE(vertices),
             });
 
-   _sprite.instbuf =
-        sg_make_buffer(
-            &(sg_buffer_desc) {
-                .type = SG_BUFFERTYPE_VERTEXBUFFER,
-                .usage = SG_USAGE_STREAM,
-                .size = SPRITE_MAX_INSTANCES * sizeof(sprite_instance_t),
-            });
-
     _sprite.shd = sg_make_shader(sprite_sprite_shader_desc(sg_query_backend()));
-    _sprite.pip =
-        sg_make_pipeline(
-            &(sg_pipeline_desc) {
-                .layout = {
-                    .buffers[1].step_func = SG_VERTEXSTEP_PER_INSTANCE,
-                    .buffers[1].stride = sizeof(sprite_instance_t),
-                    .attrs = {
-                        [ATTR_sprite_vs_a_position] = {
-                            .format = SG_VERTEXFORMAT_FLOAT2,
-                            .offset = offsetof(sprite_vertex_t, position),
-                            .buffer_index = 0,
-                        },
-                        [ATTR_sprite_vs_a_texcoord0] = {
-                            .format = SG_VERTEXFORMAT_FLOAT2,
-                            .offset = offsetof(sprite_vertex_t, texcoord),
-                            .buffer_index = 0,
-                        },
-                        [ATTR_sprite_vs_a_offset] = {
-                            .format = SG_VERTEXFORMAT_FLOAT2,
-                            .offset = offsetof(sprite_instance_t, offset),
-                            .buffer_index = 1,
-                        },
-                        [ATTR_sprite_vs_a_scale] = {
-                            .format = SG_VERTEXFORMAT_FLOAT2,
-                            .offset = offsetof(sprite_instance_t, scale),
-                            .buffer_index = 1,
-                        },
-                        [ATTR_sprite_vs_a_uvmin] = {
-                            .format = SG_VERTEXFORMAT_FLOAT2,
-                            .offset = offsetof(sprite_instance_t, uv_min),
-                            .buffer_index = 1,
-                        },
-                        [ATTR_sprite_vs_a_uvmax] = {
-                            .format = SG_VERTEXFORMAT_FLOAT2,
-                            .offset = offsetof(sprite_instance_t, uv_max),
-                            .buffer_index = 1,
-                        },
-                        // TODO: convert to UBYTE4
-                        [ATTR_sprite_vs_a_color] = {
-                            .format = SG_VERTEXFORMAT_FLOAT4,
-                            .offset = offsetof(sprite_instance_t, color),
-                            .buffer_index = 1,
-                        },
-                        [ATTR_sprite_vs_a_z] = {
-                            .format = SG_VERTEXFORMAT_FLOAT,
-                            .offset = offsetof(sprite_instance_t, z),
-                            .buffer_index = 1,
-                        },
-                        [ATTR_sprite_vs_a_flags] = {
-                            .format = SG_VERTEXFORMAT_FLOAT,
-                            .offset = offsetof(sprite_instance_t, flags),
-                            .buffer_index = 1,
-                        },
-                    }
+
+    sg_pipeline_desc desc = {
+        .layout = {
+            .buffers[1].step_func = SG_VERTEXSTEP_PER_INSTANCE,
+            .buffers[1].stride = sizeof(sprite_instance_t),
+            .attrs = {
+                [ATTR_sprite_vs_a_position] = {
+                    .format = SG_VERTEXFORMAT_FLOAT2,
+                    .offset = offsetof(sprite_vertex_t, position),
+                    .buffer_index = 0,
                 },
-                .shader = _sprite.shd,
-                .primitive_type = SG_PRIMITIVETYPE_TRIANGLES,
-                .index_type = SG_INDEXTYPE_UINT16,
-                .cull_mode = SG_CULLMODE_NONE, // TODO: cull
-                .face_winding = SG_FACEWINDING_CCW, // TODO: correct?
-                .colors[0].blend = {
-                    .enabled = true,
-                    .src_factor_rgb = SG_BLENDFACTOR_SRC_ALPHA,
-                    .dst_factor_rgb = SG_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+                [ATTR_sprite_vs_a_texcoord0] = {
+                    .format = SG_VERTEXFORMAT_FLOAT2,
+                    .offset = offsetof(sprite_vertex_t, texcoord),
+                    .buffer_index = 0,
                 },
-                .depth = {
-                    .compare = SG_COMPAREFUNC_LESS_EQUAL,
-                    .write_enabled = true,
+                [ATTR_sprite_vs_a_offset] = {
+                    .format = SG_VERTEXFORMAT_SHORT2,
+                    .offset = offsetof(sprite_instance_t, offset),
+                    .buffer_index = 1,
                 },
-                .label = "sprite-pipeline",
-            });
+                [ATTR_sprite_vs_a_uv] = {
+                    .format = SG_VERTEXFORMAT_SHORT4,
+                    .offset = offsetof(sprite_instance_t, uv),
+                    .buffer_index = 1,
+                },
+                [ATTR_sprite_vs_a_color] = {
+                    .format = SG_VERTEXFORMAT_UBYTE4N,
+                    .offset = offsetof(sprite_instance_t, color),
+                    .buffer_index = 1,
+                },
+                [ATTR_sprite_vs_a_z] = {
+                    .format = SG_VERTEXFORMAT_FLOAT,
+                    .offset = offsetof(sprite_instance_t, z),
+                    .buffer_index = 1,
+                },
+                // GL backends read all attributes as floats, flags are
+                // small enough to survive the conversion
+                [ATTR_sprite_vs_a_flags] = {
+                    .format = SG_VERTEXFORMAT_UBYTE4,
+                    .offset = offsetof(sprite_instance_t, flags),
+                    .buffer_index = 1,
+                },
+            }
+        },
+        .shader = _sprite.shd,
+        .primitive_type = SG_PRIMITIVETYPE_TRIANGLES,
+        .index_type = SG_INDEXTYPE_UINT16,
+        .cull_mode = SG_CULLMODE_NONE, // TODO: cull
+        .face_winding = SG_FACEWINDING_CCW, // TODO: correct?
+        .colors[0].blend = {
+            .enabled = true,
+            .src_factor_rgb = SG_BLENDFACTOR_SRC_ALPHA,
+            .dst_factor_rgb = SG_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+        },
+        .depth = {
+            .compare = SG_COMPAREFUNC_LESS_EQUAL,
+            .write_enabled = true,
+        },
+        .label = "sprite-pipeline",
+    };
+    _sprite.pip = sg_make_pipeline(&desc);
+
+    // translucent sprites of sorted batches, still depth tested against
+    // everything opaque
+    desc.depth.write_enabled = false;
+    desc.label = "sprite-pipeline-blend";
+    _sprite.pip_blend = sg_make_pipeline(&desc);
 }
 
 void sprite_atlas_init(
@@ -320,85 +503,284 @@ void sprite_batch_destroy(sprite_batch_t *batch) {
 }
 
 void sprite_batch_push(sprite_batch_t *batch, const sprite_t *sprite) {
-    const v2
-        uv_min =
-            v2_mul(
-                v2_from_i(
-                    v2i_mul(sprite->index, batch->atlas->sprite_size_px)),
-                batch->atlas->tx_per_px),
-        uv_max = v2_add(uv_min, batch->atlas->sprite_size_tx);
-
-    *dynlist_push(batch->sprites) = (sprite_instance_t) {
-        .offset = sprite->pos,
-        .scale = v2_from_i(batch->atlas->sprite_size_px),
-        .uv_min = uv_min,
-        .uv_max = uv_max,
-        .color = sprite->color,
-        .z = sprite->z,
-        .flags = i32_bits_to_f32(sprite->flags),
-    };
+    batch->sorted = false;
+    *dynlist_push(batch->sprites) =
+        sprite_instance_pack(
+            sprite->pos,
+            sprite->z,
+            v2i_mul(sprite->index, batch->atlas->sprite_size_px),
+            batch->atlas->sprite_size_px,
+            sprite->color,
+            sprite->flags);
 }
 
 void sprite_batch_push_subimage(
     sprite_batch_t *batch,
     const sprite_t *sprite,
     boxi_t box) {
-    const v2
-        uv_min = v2_mul(v2_from_i(box.min), batch->atlas->tx_per_px),
-        uv_max = v2_mul(v2_add(v2_from_i(box.max), v2_of(1)), batch->atlas->tx_per_px);
-
-    *dynlist_push(batch->sprites) = (sprite_instance_t) {
-        .offset = sprite->pos,
-        .scale = v2_from_i(boxi_size(box)),
-        .uv_min = uv_min,
-        .uv_max = uv_max,
-        .color = sprite->color,
-        .z = sprite->z,
-        .flags = i32_bits_to_f32(sprite->flags),
-    };
+    batch->sorted = false;
+    *dynlist_push(batch->sprites) =
+        sprite_instance_pack(
+            sprite->pos,
+            sprite->z,
+            box.min,
+            boxi_size(box),
+            sprite->color,
+            sprite->flags);
 }
 
-void sprite_batch_draw(
-    const sprite_batch_t *batch,
-    const m4 *model,
-    const m4 *view,
-    const m4 *proj) {
-    sprite_lazy_init();
+void sprite_batch_push_subimages(
+    sprite_batch_t *batch,
+    boxi_t box,
+    int n,
+    const f32 *x,
+    const f32 *y,
+    const v4 *color,
+    f32 z,
+    f32 z_step,
+    int flags) {
+    const v2i size = boxi_size(box);
+
+    batch->sorted = false;
+
+    const int offset = dynlist_size(batch->sprites);
+    dynlist_resize_no_contract(batch->sprites, offset + n);
+
+    sprite_instance_t *dst = &batch->sprites[offset];
+    for (int i = 0; i < n; i++) {
+        dst[i] =
+            sprite_instance_pack(
+                v2_of(x[i], y[i]),
+                z + (i * z_step),
+                box.min,
+                size,
+                color[i],
+                flags);
+    }
+}
+
+// orders by (pass, z descending, order): translucent in the top bit, then z
+// mapped so that unsigned comparison sorts floats descending, then order
+M_INLINE u64 sprite_sort_key(const sprite_instance_t *s, u32 order) {
+    const union { f32 f; u32 u; } bits = { .f = s->z };
+    const u32 z = (bits.u & 0x80000000) ? bits.u : ~(bits.u | 0x80000000);
+
+    return
+        (((u64) (s->color[3] < 255)) << 63)
+        | (((u64) z) << 31)
+        | (order & 0x7FFFFFFF);
+}
+
+void sprite_batch_sort(sprite_batch_t *batch) {
+    const int n = dynlist_size(batch->sprites);
+
+    u64
+        *keys = mem_alloc(thread_scratch(), n * sizeof(u64)),
+        *tmp = mem_alloc(thread_scratch(), n * sizeof(u64));
 
-    // upload instances
-    const int offset =
-        sg_append_buffer(
-            _sprite.instbuf,
-            &sg_range_from_dynlist(batch->sprites));
+    for (int i = 0; i < n; i++) {
+        keys[i] = sprite_sort_key(&batch->sprites[i], i);
+    }
+
+    sort_radix_u64(keys, n, tmp);
+
+    sprite_instance_t *sorted =
+        mem_alloc(thread_scratch(), n * sizeof(sprite_instance_t));
+
+    batch->n_opaque = n;
+    for (int i = 0; i < n; i++) {
+        sorted[i] = batch->sprites[keys[i] & 0x7FFFFFFF];
 
-    if (sg_query_buffer_overflow(_sprite.instbuf)) {
-        WARN("not all sprites drawn, internal buffer overflow");
+        if ((keys[i] >> 63) && batch->n_opaque == n) {
+            batch->n_opaque = i;
+        }
     }
 
-    sg_apply_pipeline(_sprite.pip);
-    sg_apply_bindings(
-        &(sg_bindings) {
-            .index_buffer = _sprite.ibuf,
-            .vertex_buffers[0] = _sprite.vbuf,
-            .vertex_buffers[1] = _sprite.instbuf,
-            .vertex_buffer_offsets[1] = offset,
-            .fs.images[0] = batch->atlas->image,
-            .fs.samplers[0] = batch->atlas->sampler,
-        });
+    memcpy(batch->sprites, sorted, n * sizeof(sprite_instance_t));
+    batch->sorted = true;
 
+    mem_free(thread_scratch(), sorted);
+    mem_free(thread_scratch(), tmp);
+    mem_free(thread_scratch(), keys);
+}
+
+static sprite_vs_params_t sprite_vs_params(
+    const m4 *model,
+    const m4 *view,
+    const m4 *proj) {
     sprite_vs_params_t vs_params;
 
     const m4 identity = m4_identity();
     memcpy(vs_params.model, model ? model->raw : identity.raw, sizeof(*model));
     memcpy(vs_params.view, view, sizeof(*view));
     memcpy(vs_params.proj, proj, sizeof(*proj));
+    return vs_params;
+}
+
+const sprite_stats_t *sprite_stats() {
+    return &_sprite.stats;
+}
+
+void sprite_reset_stats() {
+    _sprite.stats = (sprite_stats_t) { .buffers = _sprite.n_instbufs };
+}
+
+// bytes appended to buf this frame. sokol rewinds append cursors lazily on the
+// first append of a frame, sg_query_buffer_will_overflow accounts for that
+static int sprite_instbuf_used(sg_buffer buf) {
+    const int size = SPRITE_CHUNK_INSTANCES * sizeof(sprite_instance_t);
+    return
+        sg_query_buffer_will_overflow(buf, size) ?
+            sg_query_buffer_info(buf).append_pos
+            : 0;
+}
+
+// appends as many of n instances as fit into the first instance buffer with
+// room, creating one if needed. returns how many were appended, 0 if
+// SPRITE_MAX_BUFFERS are full
+static int sprite_upload(
+    const sprite_instance_t *instances,
+    int n,
+    sg_buffer *buf,
+    int *offset) {
+    const int size = SPRITE_CHUNK_INSTANCES * sizeof(sprite_instance_t);
+
+    for (int i = 0; i < SPRITE_MAX_BUFFERS; i++) {
+        if (i == _sprite.n_instbufs) {
+            _sprite.instbufs[_sprite.n_instbufs++] =
+                sg_make_buffer(
+                    &(sg_buffer_desc) {
+                        .type = SG_BUFFERTYPE_VERTEXBUFFER,
+                        .usage = SG_USAGE_STREAM,
+                        .size = size,
+                        .label = "sprite-instances",
+                    });
+            _sprite.stats.buffers = _sprite.n_instbufs;
+        }
+
+        const int room =
+            (size - sprite_instbuf_used(_sprite.instbufs[i]))
+                / (int) sizeof(sprite_instance_t);
+        if (room == 0) { continue; }
+
+        const int m = min(n, room);
+        *buf = _sprite.instbufs[i];
+        *offset =
+            sg_append_buffer(
+                *buf,
+                &(sg_range) {
+                    .ptr = instances,
+                    .size = m * sizeof(sprite_instance_t),
+                });
+
+        _sprite.stats.bytes += m * sizeof(sprite_instance_t);
+        _sprite.stats.chunks++;
+        return m;
+    }
+
+    return 0;
+}
 
+// uploads and draws n instances textured with image in as many chunks as
+// needed. pipeline and uniforms must already be applied
+static void sprite_draw_instances(
+    const sprite_instance_t *instances,
+    int n,
+    sg_image image,
+    sg_sampler sampler) {
+    while (n > 0) {
+        sg_buffer buf;
+        int offset;
+
+        const int m = sprite_upload(instances, n, &buf, &offset);
+        if (m == 0) {
+            WARN("not all sprites drawn, out of instance buffers");
+            _sprite.stats.dropped += n;
+            return;
+        }
+
+        sg_apply_bindings(
+            &(sg_bindings) {
+                .index_buffer = _sprite.ibuf,
+                .vertex_buffers[0] = _sprite.vbuf,
+                .vertex_buffers[1] = buf,
+                .vertex_buffer_offsets[1] = offset,
+                .fs.images[0] = image,
+                .fs.samplers[0] = sampler,
+            });
+
+        sg_draw(0, 6, m);
+
+        instances += m;
+        n -= m;
+    }
+}
+
+static void sprite_apply(sg_pipeline pip, const sprite_vs_params_t *vs_params) {
+    sg_apply_pipeline(pip);
     sg_apply_uniforms(
         SG_SHADERSTAGE_VS,
         SLOT_sprite_vs_params,
-        &SG_RANGE(vs_params));
+        &SG_RANGE(*vs_params));
+}
+
+void sprite_batch_draw(
+    const sprite_batch_t *batch,
+    const m4 *model,
+    const m4 *view,
+    const m4 *proj) {
+    const int n = dynlist_size(batch->sprites);
+    if (n == 0) { return; }
 
-    sg_draw(0, 6, dynlist_size(batch->sprites));
+    sprite_lazy_init();
+
+    const sprite_vs_params_t vs_params = sprite_vs_params(model, view, proj);
+    const int n_opaque = batch->sorted ? batch->n_opaque : n;
+
+    if (n_opaque != 0) {
+        sprite_apply(_sprite.pip, &vs_params);
+        sprite_draw_instances(
+            batch->sprites,
+            n_opaque,
+            batch->atlas->image,
+            batch->atlas->sampler);
+    }
+
+    if (n_opaque != n) {
+        sprite_apply(_sprite.pip_blend, &vs_params);
+        sprite_draw_instances(
+            &batch->sprites[n_opaque],
+            n - n_opaque,
+            batch->atlas->image,
+            batch->atlas->sampler);
+    }
+}
+
+// instance for all of image if box is NULL, otherwise box of image
+static sprite_instance_t sprite_image_instance(
+    sg_image image,
+    const boxi_t *box,
+    v2 pos,
+    f32 z,
+    v4 color,
+    int flags) {
+    v2i size;
+
+    if (box) {
+        size = boxi_size(*box);
+    } else {
+        const sg_image_desc desc = sg_query_image_desc(image);
+        size = v2i_of(desc.width, desc.height);
+    }
+
+    return
+        sprite_instance_pack(
+            pos,
+            z,
+            box ? box->min : v2i_of(0),
+            size,
+            color,
+            flags);
 }
 
 void sprite_draw_direct(
@@ -413,67 +795,195 @@ void sprite_draw_direct(
     const m4 *proj) {
     sprite_lazy_init();
 
-    sg_image_desc desc = sg_query_image_desc(image);
+    const sprite_instance_t instance =
+        sprite_image_instance(image, box, pos, z, color, flags);
 
-    v2 uv_min, uv_max;
-    v2i size;
+    const sprite_vs_params_t vs_params = sprite_vs_params(model, view, proj);
+    sprite_apply(_sprite.pip, &vs_params);
+    sprite_draw_instances(&instance, 1, image, _sprite.smp);
+}
 
-    if (box) {
-        size = boxi_size(*box);
+void sprite_image_atlas_init(
+    sprite_image_atlas_t *atlas,
+    allocator_t *a,
+    v2i page_size) {
+    *atlas = (sprite_image_atlas_t) {
+        .allocator = a,
+        .page_size = page_size,
+        .pages = dynlist_create(sprite_image_page_t, a),
+    };
+}
 
-        const v2 scale = v2_div(v2_of(1), v2_of(desc.width, desc.height));
-        uv_min = v2_mul(v2_from_i(box->min), scale);
-        uv_max = v2_mul(v2_from_i(box->max), scale);
-    } else {
-        size = v2i_of(desc.width, desc.height);
-        uv_min = v2_of(0);
-        uv_max = v2_of(1);
+void sprite_image_atlas_destroy(sprite_image_atlas_t *atlas) {
+    dynlist_each(atlas->pages, it) {
+        skyline_destroy(&it.el->skyline);
+        sg_destroy_image(it.el->image);
+
+        if (it.el->data) {
+            mem_free(atlas->allocator, it.el->data);
+        }
     }
 
-    const sprite_instance_t instance = {
-        .offset = pos,
-        .z = z,
-        .scale = v2_from_i(size),
-        .color = color,
-        .flags = i32_bits_to_f32(flags),
-        .uv_min = uv_min,
-        .uv_max = uv_max,
+    dynlist_destroy(atlas->pages);
+    *atlas = (sprite_image_atlas_t) { 0 };
+}
+
+sprite_image_t sprite_image_atlas_add(
+    sprite_image_atlas_t *atlas,
+    const u8 *data,
+    v2i size) {
+    const v2i padded = v2i_add(size, v2i_of(2 * SPRITE_IMAGE_ATLAS_PADDING));
+
+    sprite_image_page_t *page = NULL;
+    v2i pos;
+
+    dynlist_each(atlas->pages, it) {
+        if (it.el->data && skyline_insert(&it.el->skyline, padded, &pos)) {
+            page = it.el;
+            break;
+        }
+    }
+
+    if (!page) {
+        const v2i page_size = v2i_max(atlas->page_size, padded);
+
+        page = dynlist_push(atlas->pages);
+        *page = (sprite_image_page_t) {
+            .data = mem_alloc(atlas->allocator, page_size.x * page_size.y * 4),
+            .image = sg_alloc_image(),
+        };
+
+        memset(page->data, 0, page_size.x * page_size.y * 4);
+        skyline_init(&page->skyline, atlas->allocator, page_size);
+        ASSERT(skyline_insert(&page->skyline, padded, &pos));
+    }
+
+    pos = v2i_add(pos, v2i_of(SPRITE_IMAGE_ATLAS_PADDING));
+
+    const int stride = page->skyline.size.x * 4;
+    for (int y = 0; y < size.y; y++) {
+        memcpy(
+            &page->data[((pos.y + y) * stride) + (pos.x * 4)],
+            &data[y * size.x * 4],
+            size.x * 4);
+    }
+
+    return (sprite_image_t) {
+        .image = page->image,
+        .box = boxi_ps(pos, size),
     };
+}
+
+void sprite_image_atlas_build(sprite_image_atlas_t *atlas) {
+    dynlist_each(atlas->pages, it) {
+        sprite_image_page_t *page = it.el;
+        if (!page->data) { continue; }
 
-    // upload instance
-    const int offset =
-        sg_append_buffer(
-            _sprite.instbuf,
-            &SG_RANGE(instance));
+        const v2i size = page->skyline.size;
+        sg_init_image(
+            page->image,
+            &(sg_image_desc) {
+                .type = SG_IMAGETYPE_2D,
+                .usage = SG_USAGE_IMMUTABLE,
+                .pixel_format = SG_PIXELFORMAT_RGBA8,
+                .width = size.x,
+                .height = size.y,
+                .data.subimage[0][0] = {
+                    .ptr = page->data,
+                    .size = size.x * size.y * 4,
+                },
+                .label = "sprite-image-page",
+            });
 
-    if (sg_query_buffer_overflow(_sprite.instbuf)) {
-        WARN("internal buffer overflow");
+        mem_free(atlas->allocator, page->data);
+        page->data = NULL;
     }
+}
 
-    sg_apply_pipeline(_sprite.pip);
-    sg_apply_bindings(
-        &(sg_bindings) {
-            .index_buffer = _sprite.ibuf,
-            .vertex_buffers[0] = _sprite.vbuf,
-            .vertex_buffers[1] = _sprite.instbuf,
-            .vertex_buffer_offsets[1] = offset,
-            .fs.images[0] = image,
-            .fs.samplers[0] = _sprite.smp,
-        });
+void sprite_image_batch_init(sprite_image_batch_t *batch, allocator_t *a) {
+    *batch = (sprite_image_batch_t) {
+        .draws = dynlist_create(sprite_image_draw_t, a),
+    };
+}
 
-    sprite_vs_params_t vs_params;
+void sprite_image_batch_destroy(sprite_image_batch_t *batch) {
+    dynlist_destroy(batch->draws);
+    *batch = (sprite_image_batch_t) { 0 };
+}
 
-    const m4 identity = m4_identity();
-    memcpy(vs_params.model, model ? model->raw : identity.raw, sizeof(*model));
-    memcpy(vs_params.view, view, sizeof(*view));
-    memcpy(vs_params.proj, proj, sizeof(*proj));
+void sprite_image_batch_push(
+    sprite_image_batch_t *batch,
+    sg_image image,
+    const boxi_t *box,
+    v2 pos,
+    f32 z,
+    v4 color,
+    int flags) {
+    *dynlist_push(batch->draws) = (sprite_image_draw_t) {
+        .image = image,
+        .instance = sprite_image_instance(image, box, pos, z, color, flags),
+    };
+}
 
-    sg_apply_uniforms(
-        SG_SHADERSTAGE_VS,
-        SLOT_sprite_vs_params,
-        &SG_RANGE(vs_params));
+void sprite_image_batch_push_image(
+    sprite_image_batch_t *batch,
+    const sprite_image_t *image,
+    v2 pos,
+    f32 z,
+    v4 color,
+    int flags) {
+    sprite_image_batch_push(
+        batch, image->image, &image->box, pos, z, color, flags);
+}
+
+void sprite_image_batch_draw(
+    const sprite_image_batch_t *batch,
+    const m4 *model,
+    const m4 *view,
+    const m4 *proj) {
+    const int n = dynlist_size(batch->draws);
+    if (n == 0) { return; }
+
+    sprite_lazy_init();
+
+    // group by image id, push order within each image
+    u64
+        *keys = mem_alloc(thread_scratch(), n * sizeof(u64)),
+        *tmp = mem_alloc(thread_scratch(), n * sizeof(u64));
+
+    for (int i = 0; i < n; i++) {
+        keys[i] = (((u64) batch->draws[i].image.id) << 32) | i;
+    }
+
+    sort_radix_u64(keys, n, tmp);
+
+    sprite_instance_t *instances =
+        mem_alloc(thread_scratch(), n * sizeof(sprite_instance_t));
+
+    for (int i = 0; i < n; i++) {
+        instances[i] = batch->draws[keys[i] & 0xFFFFFFFF].instance;
+    }
+
+    const sprite_vs_params_t vs_params = sprite_vs_params(model, view, proj);
+    sprite_apply(_sprite.pip, &vs_params);
+
+    for (int i = 0; i < n;) {
+        const u32 id = keys[i] >> 32;
+
+        int j = i + 1;
+        while (j < n && (keys[j] >> 32) == id) { j++; }
+
+        sprite_draw_instances(
+            &instances[i],
+            j - i,
+            batch->draws[keys[i] & 0xFFFFFFFF].image,
+            _sprite.smp);
+        i = j;
+    }
 
-    sg_draw(0, 6, 1);
+    mem_free(thread_scratch(), instances);
+    mem_free(thread_scratch(), tmp);
+    mem_free(thread_scratch(), keys);
 }
 
 #endif // ifdef UTIL_IMPL
@@ -0,0 +1,277 @@
+#pragma once
+
+#include "types.h"
+#include "macros.h"
+#include "thread.h"
+
+// implements task_pool_t, a fixed set of worker threads, and task_graph_t, a
+// list of tasks run on a pool with dependencies derived from what each task
+// declares it reads and writes
+//
+// resources are bits of a u64 chosen by the caller. a task depends on every
+// earlier task it conflicts with (either one writes something the other reads
+// or writes), so conflicting tasks always run in the order they were added and
+// a graph produces the same results no matter how many threads run it. tasks
+// can be split into parts which run concurrently, parts of one task must not
+// conflict with each other (typically disjoint ranges of the same data).
+
+#define TASK_GRAPH_MAX_TASKS 32
+
+// runs part (of n_parts) of a task
+typedef void (*task_f)(void *userdata, int part, int n_parts);
+
+typedef struct {
+    const char *name;
+
+    task_f f;
+    void *userdata;
+
+    // bitmasks of resources read/written
+    u64 reads, writes;
+
+    // number of times f is called, 0 is the same as 1
+    int parts;
+} task_t;
+
+typedef struct task_graph {
+    task_t tasks[TASK_GRAPH_MAX_TASKS];
+    int n;
+
+    // bit j of deps[i] set if task i must wait for task j
+    u32 deps[TASK_GRAPH_MAX_TASKS];
+} task_graph_t;
+
+typedef struct task_pool {
+    thrd_t *threads;
+    int n_threads;
+
+    // called on a pool thread with the context passed to task_graph_run before
+    // it runs any part of that graph, so threads can adopt the caller's state.
+    // can be NULL
+    void (*enter)(void *context);
+
+    // work is signalled whenever a task finishes or the pool is told to quit
+    mtx_t lock;
+    cnd_t work;
+    bool quit;
+
+    // graph being run, NULL when idle
+    task_graph_t *graph;
+    void *context;
+
+    // bumped for every graph run
+    u64 generation;
+
+    // bitmask of finished tasks
+    u32 finished;
+
+    // parts of graph in flight
+    int active;
+
+    // next part to hand out, parts not yet finished per task
+    int next_part[TASK_GRAPH_MAX_TASKS];
+    int remaining[TASK_GRAPH_MAX_TASKS];
+} task_pool_t;
+
+// starts n_threads worker threads, the thread calling task_graph_run always
+// works too so n_threads = 0 is valid and runs everything on the caller
+void task_pool_init(task_pool_t *p, int n_threads, void (*enter)(void*));
+
+void task_pool_destroy(task_pool_t *p);
+
+void task_graph_init(task_graph_t *tg);
+
+// add task, returns its index
+int task_graph_add(task_graph_t *tg, const task_t *task);
+
+// runs every task of tg, returns once all have finished. p may be NULL to run
+// every part of every task serially in order on the calling thread.
+// thread_scratch() of pool threads is reset when they pick up a new graph, so
+// memory a task allocates there stays valid until the next task_graph_run on
+// the same pool
+void task_graph_run(task_pool_t *p, task_graph_t *tg, void *context);
+
+#ifdef UTIL_IMPL
+
+#include "assert.h"
+#include "alloc.h"
+#include "math.h"
+
+// finds a part which can run and claims it, returns false if there is none.
+// must hold p->lock
+static bool task_pool_claim(task_pool_t *p, int *task, int *part) {
+    if (!p->graph) { return false; }
+
+    task_graph_t *tg = p->graph;
+    for (int i = 0; i < tg->n; i++) {
+        const int parts = max(tg->tasks[i].parts, 1);
+
+        if (p->next_part[i] < parts
+            && (tg->deps[i] & p->finished) == tg->deps[i]) {
+            *task = i;
+            *part = p->next_part[i]++;
+            p->active++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// runs claimed part, takes and returns with p->lock held
+static void task_pool_exec(task_pool_t *p, int task, int part) {
+    const task_t *t = &p->graph->tasks[task];
+    const int parts = max(t->parts, 1);
+
+    ASSERT(mtx_unlock(&p->lock) == thrd_success);
+    t->f(t->userdata, part, parts);
+    ASSERT(mtx_lock(&p->lock) == thrd_success);
+
+    p->active--;
+
+    if (--p->remaining[task] == 0) {
+        p->finished |= 1u << task;
+
+        // dependents may be runnable now, or the graph is done
+        ASSERT(cnd_broadcast(&p->work) == thrd_success);
+    }
+}
+
+static int task_pool_worker(void *arg) {
+    task_pool_t *p = arg;
+    u64 generation = 0;
+
+    ASSERT(mtx_lock(&p->lock) == thrd_success);
+
+    while (!p->quit) {
+        int task, part;
+        if (!task_pool_claim(p, &task, &part)) {
+            ASSERT(cnd_wait(&p->work, &p->lock) == thrd_success);
+            continue;
+        }
+
+        if (generation != p->generation) {
+            generation = p->generation;
+            bump_allocator_reset(thread_scratch(), 1 * 1024 * 1024);
+
+            if (p->enter) { p->enter(p->context); }
+        }
+
+        task_pool_exec(p, task, part);
+    }
+
+    ASSERT(mtx_unlock(&p->lock) == thrd_success);
+    return 0;
+}
+
+void task_pool_init(task_pool_t *p, int n_threads, void (*enter)(void*)) {
+    *p = (task_pool_t) {
+        .n_threads = max(n_threads, 0),
+        .enter = enter,
+    };
+
+    ASSERT(mtx_init(&p->lock, mtx_plain) == thrd_success);
+    ASSERT(cnd_init(&p->work) == thrd_success);
+
+    if (p->n_threads > 0) {
+        p->threads = mem_alloc(g_mallocator, p->n_threads * sizeof(thrd_t));
+    }
+
+    for (int i = 0; i < p->n_threads; i++) {
+        ASSERT(
+            thrd_create(&p->threads[i], task_pool_worker, p) == thrd_success);
+    }
+}
+
+void task_pool_destroy(task_pool_t *p) {
+    ASSERT(mtx_lock(&p->lock) == thrd_success);
+    ASSERT(!p->graph, "destroying task pool while it is running a graph");
+    p->quit = true;
+    ASSERT(cnd_broadcast(&p->work) == thrd_success);
+    ASSERT(mtx_unlock(&p->lock) == thrd_success);
+
+    for (int i = 0; i < p->n_threads; i++) {
+        thrd_join(p->threads[i], NULL);
+    }
+
+    if (p->threads) { mem_free(g_mallocator, p->threads); }
+    mtx_destroy(&p->lock);
+    cnd_destroy(&p->work);
+    *p = (task_pool_t) { 0 };
+}
+
+void task_graph_init(task_graph_t *tg) {
+    tg->n = 0;
+}
+
+int task_graph_add(task_graph_t *tg, const task_t *task) {
+    ASSERT(tg->n < TASK_GRAPH_MAX_TASKS);
+    ASSERT(task->f);
+
+    const int i = tg->n++;
+    tg->tasks[i] = *task;
+    tg->deps[i] = 0;
+
+    for (int j = 0; j < i; j++) {
+        const task_t *t = &tg->tasks[j];
+        if ((t->writes & (task->reads | task->writes))
+            || (t->reads & task->writes)) {
+            tg->deps[i] |= 1u << j;
+        }
+    }
+
+    return i;
+}
+
+void task_graph_run(task_pool_t *p, task_graph_t *tg, void *context) {
+    if (tg->n == 0) { return; }
+
+    if (!p || p->n_threads == 0) {
+        // tasks are in dependency order already
+        for (int i = 0; i < tg->n; i++) {
+            const task_t *t = &tg->tasks[i];
+            const int parts = max(t->parts, 1);
+            for (int j = 0; j < parts; j++) {
+                t->f(t->userdata, j, parts);
+            }
+        }
+
+        return;
+    }
+
+    ASSERT(mtx_lock(&p->lock) == thrd_success);
+    ASSERT(!p->graph, "task pool is already running a graph");
+
+    p->graph = tg;
+    p->context = context;
+    p->generation++;
+    p->finished = 0;
+    p->active = 0;
+
+    for (int i = 0; i < tg->n; i++) {
+        p->next_part[i] = 0;
+        p->remaining[i] = max(tg->tasks[i].parts, 1);
+    }
+
+    ASSERT(cnd_broadcast(&p->work) == thrd_success);
+
+    const u32 all = (u32) ((1ull << tg->n) - 1);
+
+    // work alongside the pool, a task is only finished once all of its parts
+    // are so nothing is in flight once every task is
+    while (p->finished != all) {
+        int task, part;
+        if (task_pool_claim(p, &task, &part)) {
+            task_pool_exec(p, task, part);
+        } else {
+            ASSERT(cnd_wait(&p->work, &p->lock) == thrd_success);
+        }
+    }
+
+    ASSERT(p->active == 0);
+
+    p->graph = NULL;
+    ASSERT(mtx_unlock(&p->lock) == thrd_success);
+}
+
+#endif // ifdef UTIL_IMPL
@@ -12,6 +12,7 @@
 #include "fixlist.h"    // IWYU pragma: keep
 #include "alloc.h"      // IWYU pragma: keep
 #include "any.h"        // IWYU pragma: keep
+#include "archetype.h"  // IWYU pragma: keep
 #include "bitmap.h"     // IWYU pragma: keep
 #include "blklist.h"    // IWYU pragma: keep
 #include "bytebuf.h"    // IWYU pragma: keep
@@ -32,10 +33,17 @@
 #include "macros.h"     // IWYU pragma: keep
 #include "math.h"       // IWYU pragma: keep
 #include "mem.h"        // IWYU pragma: keep
+#include "pace.h"       // IWYU pragma: keep
+#include "pick.h"       // IWYU pragma: keep
 #include "rand.h"       // IWYU pragma: keep
 #include "range.h"      // IWYU pragma: keep
+#include "replay.h"     // IWYU pragma: keep
+#include "simd.h"       // IWYU pragma: keep
+#include "skyline.h"    // IWYU pragma: keep
 #include "sort.h"       // IWYU pragma: keep
+#include "spatial.h"    // IWYU pragma: keep
 #include "str.h"        // IWYU pragma: keep
+#include "task.h"       // IWYU pragma: keep
 #include "thread.h"     // IWYU pragma: keep
 #include "time.h"       // IWYU pragma: keep
 #include "types.h"      // IWYU pragma: keep
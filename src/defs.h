@@ -2,6 +2,14 @@
 
 typedef struct sprite_batch sprite_batch_t;
 
+// fixed simulation rate, can be lowered (i.e. -DTICKS_PER_SECOND=30) to save
+// CPU as rendering interpolates tick-driven motion, see tick_alpha
+#ifndef TICKS_PER_SECOND
 #define TICKS_PER_SECOND 60
+#endif
 #define NS_PER_TICK (1000000000 / TICKS_PER_SECOND)
 #define TICK_DT_S ((f64) (NS_PER_TICK /* NOLINT */) / 1000000000.0)
+
+// default for g->time.max_ticks_per_frame, any time owed past this after a
+// stall is dropped rather than caught up
+#define MAX_TICKS_PER_FRAME 8
@@ -146,3 +146,30 @@ int font_height(const char *str) {
     }
     return h;
 }
+
+v2i font_size(const char *str) {
+    return v2i_of(font_width(str), font_height(str));
+}
+
+// open addressed on the string's address, literals never move so the size
+// stored for an address is always valid. when full, sizes are recomputed
+#define FONT_SIZE_CACHE_SIZE 64
+
+v2i font_size_const(const char *str) {
+    static struct { const char *str; v2i size; } cache[FONT_SIZE_CACHE_SIZE];
+
+    const usize h = (((u64) (uintptr_t) str * 0x9E3779B97F4A7C15ull) >> 32);
+    for (usize i = 0; i < FONT_SIZE_CACHE_SIZE; i++) {
+        typeof(&cache[0]) e = &cache[(h + i) % FONT_SIZE_CACHE_SIZE];
+
+        if (e->str == str) {
+            return e->size;
+        } else if (!e->str) {
+            e->str = str;
+            e->size = font_size(str);
+            return e->size;
+        }
+    }
+
+    return font_size(str);
+}
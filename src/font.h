@@ -23,3 +23,10 @@ void font_str(sprite_batch_t *batch, const char *str, const font_params_t *param
 int font_width(const char *str);
 
 int font_height(const char *str);
+
+// (font_width(str), font_height(str))
+v2i font_size(const char *str);
+
+// font_size memoised on the address of str, which must be immutable for the
+// life of the program (string literals). main thread only
+v2i font_size_const(const char *str);
@@ -20,11 +20,19 @@
 #include "util/math.h"
 #include "util/sound.h"
 #include "util/fixlist.h"
+#include "util/spatial.h"
+#include "util/pick.h"
+#include "util/simd.h"
+#include "util/replay.h"
+#include "util/archetype.h"
+#include "util/task.h"
+#include "util/pace.h"
 
 #include <SDL2/SDL.h>
 
 #include "palette.h"
 #include "font.h"
+#include "particle.h"
 
 #ifdef EMSCRIPTEN
 #define WINDOW_WIDTH 948
@@ -41,6 +49,14 @@
 #define STAGE_BOMB_SECONDS 45
 #define STAGE_BRIBE_SECONDS 59
 
+// spawn rates of papers/cars in events per second, plus per second since the
+// stage started (see spawner_t). these match the original per 60Hz tick chances
+// of 0.0088 + 0.0002/s and 0.035 + 0.000006/s
+#define BURN_SPAWN_BASE 0.528
+#define BURN_SPAWN_RAMP 0.012
+#define BOMB_SPAWN_BASE 2.1
+#define BOMB_SPAWN_RAMP 0.00036
+
 #define COLOR_WHITE 9
 #define COLOR_IGNORE 5
 #define COLOR_BURN 12
@@ -58,11 +74,31 @@ typedef enum {
     PAPER_KEEP,
 } paper_type_e;
 
+// papers are stored SoA so papers_integrate can run SIMD_LANES papers at a
+// time. they are never removed individually, only cleared all at once, so
+// indices are stable and double as handles (see paper_id_t).
+typedef struct {
+    allocator_t *allocator;
+
+    // capacity is always a multiple of SIMD_LANES so kernels never need a
+    // scalar tail, lanes past size hold junk
+    f32 *x, *y, *vx, *vy;
+
+    // lane mask, ~0 once the paper has landed on the desk
+    i32 *inside;
+
+    paper_type_e *type;
+
+    int size, capacity;
+
+    // incremented on clear, starts at 1
+    i32 gen;
+} paper_store_t;
+
+// stable handle to a paper, invalidated when papers are cleared. gen 0 is null
 typedef struct {
-    v2 pos, vel;
-    paper_type_e type;
-    bool inside;
-} paper_t;
+    i32 index, gen;
+} paper_id_t;
 
 typedef enum {
     CAR_RED = 0,
@@ -80,47 +116,264 @@ static int car_palette(car_type_e type) {
     }
 }
 
-typedef struct {
-    v2 pos;
-    bool right;
-    car_type_e type;
-} car_t;
+// g->cars columns
+enum {
+    CAR_POS,    // v2
+    CAR_PREV,   // v2, CAR_POS as of the previous tick
+    CAR_TYPE,   // car_type_e
+    CAR_RIGHT,  // bool, true if driving right (top lane)
+    CAR_COLUMNS
+};
+
+// g->bombs columns
+enum {
+    BOMB_POS,   // v2
+    BOMB_PREV,  // v2, BOMB_POS as of the previous tick
+    BOMB_DEST,  // v2
+    BOMB_COLUMNS
+};
+
+#define BG_WIDTH (300 / 12)
+#define BG_HEIGHT (156 / 12)
+#define BG_OFFSET (v2i_of(10, (TARGET_HEIGHT - 156) / 2))
 
+#define BRIBE_BOARD_CELLS (BG_WIDTH * BG_HEIGHT)
+#define BRIBE_BOARD_WORDS ((BRIBE_BOARD_CELLS + 63) / 64)
+
+// one bit per bribe grid cell, cell (x, y) is bit (y * BG_WIDTH) + x. bits past
+// BRIBE_BOARD_CELLS are always 0
 typedef struct {
-    v2 pos, vel;
+    u64 words[BRIBE_BOARD_WORDS];
+} bribe_board_t;
+
+M_INLINE int bribe_board_index(v2i pos) {
+    return (pos.y * BG_WIDTH) + pos.x;
+}
+
+M_INLINE bool bribe_board_in_bounds(v2i pos) {
+    return pos.x >= 0 && pos.x < BG_WIDTH && pos.y >= 0 && pos.y < BG_HEIGHT;
+}
+
+M_INLINE bool bribe_board_get(const bribe_board_t *b, v2i pos) {
+    if (!bribe_board_in_bounds(pos)) { return false; }
+    const int i = bribe_board_index(pos);
+    return (b->words[i / 64] >> (i % 64)) & 1;
+}
+
+// out of bounds positions are ignored
+M_INLINE void bribe_board_put(bribe_board_t *b, v2i pos, bool val) {
+    if (!bribe_board_in_bounds(pos)) { return; }
+    const int i = bribe_board_index(pos);
+    b->words[i / 64] =
+        (b->words[i / 64] & ~(1ull << (i % 64))) | ((u64) val << (i % 64));
+}
+
+M_INLINE int bribe_board_count(const bribe_board_t *b) {
+    int n = 0;
+    for (int i = 0; i < BRIBE_BOARD_WORDS; i++) {
+        n += popcount(b->words[i]);
+    }
+    return n;
+}
+
+// position of the nth (from 0) set bit, n must be < bribe_board_count(b)
+M_INLINE v2i bribe_board_select(const bribe_board_t *b, int n) {
+    for (int i = 0; i < BRIBE_BOARD_WORDS; i++) {
+        u64 w = b->words[i];
+        const int c = popcount(w);
+
+        if (n >= c) {
+            n -= c;
+            continue;
+        }
+
+        // drop the n lowest set bits
+        while (n-- > 0) {
+            w &= w - 1;
+        }
+
+        const int j = (i * 64) + __builtin_ctzll(w);
+        return v2i_of(j % BG_WIDTH, j / BG_WIDTH);
+    }
+
+    ASSERT(false, "bribe board has no bit %d", n);
+    return v2i_of(0);
+}
+
+#define PAPER_SIZE (v2_of(12, 14))
+
+static boxf_t paper_box(v2 pos) {
+    return boxf_ps(pos, PAPER_SIZE);
+}
+
+// collision box
+static boxf_t paper_box_small(v2 pos) {
+    return boxf_scale_center(paper_box(pos), v2_of(0.6f));
+}
+
+// later papers are drawn under earlier ones
+static f32 paper_z(int i) {
+    return 0.5f + (0.00001f * i);
+}
+
+static void paper_store_init(paper_store_t *ps, allocator_t *al) {
+    *ps = (paper_store_t) { .allocator = al, .gen = 1 };
+}
+
+static void paper_store_clear(paper_store_t *ps) {
+    ps->size = 0;
+    ps->gen++;
+}
+
+static void paper_store_grow(paper_store_t *ps) {
+    const int capacity = max(ps->capacity * 2, 4 * SIMD_LANES);
+
+    // fresh lanes are zeroed so padding never holds NaNs
+#define PAPER_STORE_GROW(_a) do {                                             \
+        typeof(ps->_a) _p = mem_calloc(ps->allocator, capacity * sizeof(*_p));\
+        if (ps->_a) {                                                         \
+            memcpy(_p, ps->_a, ps->size * sizeof(*_p));                       \
+            mem_free(ps->allocator, ps->_a);                                  \
+        }                                                                     \
+        ps->_a = _p;                                                          \
+    } while (0)
+
+    PAPER_STORE_GROW(x);
+    PAPER_STORE_GROW(y);
+    PAPER_STORE_GROW(vx);
+    PAPER_STORE_GROW(vy);
+    PAPER_STORE_GROW(inside);
+    PAPER_STORE_GROW(type);
+#undef PAPER_STORE_GROW
+
+    ps->capacity = capacity;
+}
+
+static paper_id_t paper_store_add(
+    paper_store_t *ps,
+    v2 pos,
+    v2 vel,
+    paper_type_e type) {
+    if (ps->size == ps->capacity) {
+        paper_store_grow(ps);
+    }
+
+    const int i = ps->size++;
+    ps->x[i] = pos.x;
+    ps->y[i] = pos.y;
+    ps->vx[i] = vel.x;
+    ps->vy[i] = vel.y;
+    ps->inside[i] = 0;
+    ps->type[i] = type;
+    return (paper_id_t) { .index = i, .gen = ps->gen };
+}
+
+static bool paper_store_valid(const paper_store_t *ps, paper_id_t id) {
+    return id.gen == ps->gen && id.index >= 0 && id.index < ps->size;
+}
+
+static v2 paper_pos(const paper_store_t *ps, int i) {
+    return v2_of(ps->x[i], ps->y[i]);
+}
+
+static v2 paper_vel(const paper_store_t *ps, int i) {
+    return v2_of(ps->vx[i], ps->vy[i]);
+}
+
+static void paper_set_vel(paper_store_t *ps, int i, v2 vel) {
+    ps->vx[i] = vel.x;
+    ps->vy[i] = vel.y;
+}
+
+// copies papers into dst, which must have room for paper_store_save(ps, NULL)
+// bytes. returns number of bytes written
+static usize paper_store_save(const paper_store_t *ps, void *dst) {
+    u8 *p = dst;
+    usize n = 0;
+
+    memput(p, &n, &ps->size, sizeof(ps->size));
+    memput(p, &n, &ps->gen, sizeof(ps->gen));
+    memput(p, &n, ps->x, ps->size * sizeof(*ps->x));
+    memput(p, &n, ps->y, ps->size * sizeof(*ps->y));
+    memput(p, &n, ps->vx, ps->size * sizeof(*ps->vx));
+    memput(p, &n, ps->vy, ps->size * sizeof(*ps->vy));
+    memput(p, &n, ps->inside, ps->size * sizeof(*ps->inside));
+    memput(p, &n, ps->type, ps->size * sizeof(*ps->type));
+
+    return n;
+}
+
+// restores papers saved by paper_store_save, returns number of bytes read
+static usize paper_store_restore(paper_store_t *ps, const void *src) {
+    const u8 *p = src;
 
-    bool init;
-    v2 init_pos;
-    int spawn, duration;
+    int size;
+    memget(&p, &size, sizeof(size));
 
-    v4 color;
+    while (ps->capacity < size) {
+        paper_store_grow(ps);
+    }
+
+    ps->size = size;
+    memget(&p, &ps->gen, sizeof(ps->gen));
+    memget(&p, ps->x, size * sizeof(*ps->x));
+    memget(&p, ps->y, size * sizeof(*ps->y));
+    memget(&p, ps->vx, size * sizeof(*ps->vx));
+    memget(&p, ps->vy, size * sizeof(*ps->vy));
+    memget(&p, ps->inside, size * sizeof(*ps->inside));
+    memget(&p, ps->type, size * sizeof(*ps->type));
 
-    bool is_text;
-    char text[32];
-} particle_t;
+    return p - (const u8*) src;
+}
 
+// poisson process with rate (base + (ramp * t)) events per second at t seconds
+// into a stage. one exponential sample is drawn per event instead of a random
+// chance every tick, so spawn rates do not depend on TICKS_PER_SECOND
 typedef struct {
-    v2 pos;
-    v2 dest;
-} bomb_t;
+    f64 base, ramp;
 
-typedef union {
-    struct {
-        bool player : 1;
-        bool judge: 1;
-        bool cop: 1;
-        bool money: 1;
-    };
+    // stage time in seconds of the next event
+    f64 next;
+} spawner_t;
+
+// time of the event following one at t, where the rate integrated over the gap
+// is exponentially distributed
+static f64 spawner_after(const spawner_t *sp, rand_t *r, f64 t) {
+    const f64 e = rand_exp(r, 1.0);
+
+    if (sp->ramp == 0.0) {
+        return t + (e / sp->base);
+    }
+
+    // integrated rate is base * s + ramp * s^2 / 2, solve for where it has
+    // grown by e since t
+    const f64 c = (sp->base * t) + (sp->ramp * t * t / 2.0) + e;
+    return
+        (-sp->base + sqrt((sp->base * sp->base) + (2.0 * sp->ramp * c)))
+            / sp->ramp;
+}
 
-    u8 state;
-} bribe_grid_t;
+// first event is after t seconds
+static void spawner_init(
+    spawner_t *sp,
+    rand_t *r,
+    f64 base,
+    f64 ramp,
+    f64 t) {
+    *sp = (spawner_t) { .base = base, .ramp = ramp };
+    sp->next = spawner_after(sp, r, t);
+}
 
-static boxf_t paper_box(const paper_t *p) {
-    return boxf_ps(p->pos, v2_of(12, 14));
+// true if an event is due at t and schedules the next, call until false as
+// several can be due in one tick
+static bool spawner_due(spawner_t *sp, rand_t *r, f64 t) {
+    if (t < sp->next) { return false; }
+    sp->next = spawner_after(sp, r, sp->next);
+    return true;
 }
 
-static boxf_t car_box(const car_t *c) {
-    return boxf_ps(c->pos, v2_of(13, 9));
+static boxf_t car_box(v2 pos) {
+    return boxf_ps(pos, v2_of(13, 9));
 }
 
 typedef struct {
@@ -133,9 +386,46 @@ typedef struct {
     input_t input;
     bool quit;
 
+    // input recording/playback, see --record/--replay
+    replay_t replay;
+
+    // limits frame rate, see --fps
+    frame_pacer_t pacer;
+
+    // true if swaps wait for vblank
+    bool vsync;
+
+    // see --stress-particles
+    struct {
+        // particles kept alive, 0 if off
+        int particles;
+
+        // separate from g->rand so the simulation is unaffected
+        rand_t rand;
+    } stress;
+
+    struct {
+        // idle_scene_key() of what is on screen, 0 if it can change by itself
+        hash_t key;
+
+        // true if the last frame had nothing new to draw, the next frame
+        // waits for input or the next animation step instead of pacing
+        bool active;
+
+        // frames which skipped rendering, reset every second
+        u64 skipped;
+    } idle;
+
+    // runs simulation task graphs, NULL runs them serially on the calling
+    // thread
+    task_pool_t *tasks;
+
     sprite_batch_t batch;
     sprite_atlas_t atlas;
 
+    // whole images (backgrounds, overlays), drawn before the other batches
+    sprite_image_batch_t image_batch;
+
     sprite_batch_t font_batch;
     sprite_atlas_t font_atlas;
 
@@ -144,17 +434,34 @@ typedef struct {
         sg_attachments attachments;
     } offscreen;
 
+    // all of images, packed into as few textures as possible
+    sprite_image_atlas_t image_atlas;
+
     struct {
-        sg_image bg_burn[3];
-        sg_image fg_burn;
-        sg_image bg_bomb[3];
-        sg_image fg_bomb;
-        sg_image fg_bribe;
-        sg_image times_up;
-        sg_image caught;
-        sg_image logo;
+        sprite_image_t bg_burn[3];
+        sprite_image_t fg_burn;
+        sprite_image_t bg_bomb[3];
+        sprite_image_t fg_bomb;
+        sprite_image_t fg_bribe;
+        sprite_image_t times_up;
+        sprite_image_t caught;
+        sprite_image_t logo;
     } images;
 
+    // resolved once in platform_init, SOUND_SOURCE_NONE when headless
+    struct {
+        sound_source_t select;
+        sound_source_t doc;
+        sound_source_t bomb;
+        sound_source_t drop;
+        sound_source_t money;
+        sound_source_t bribe;
+        sound_source_t poor;
+        sound_source_t caught;
+        sound_source_t time;
+        sound_source_t blip2;
+    } sounds;
+
     struct {
         f64 now_s, dt_s;
         u64 now;
@@ -162,6 +469,18 @@ typedef struct {
         u64 last_second;
         u64 frames, second_frames, fps;
         u64 ticks, second_ticks, tps;
+
+        // cap on ticks run by a single frame
+        u64 max_ticks_per_frame;
+
+        // ticks run as catch-up in a frame which already ran one
+        u64 coalesced_ticks;
+
+        // ticks owed but discarded because a frame hit max_ticks_per_frame
+        u64 dropped_ticks;
+
+        // frames which hit max_ticks_per_frame
+        u64 overrun_frames;
     } time;
 
     struct {
@@ -170,9 +489,9 @@ typedef struct {
         v2 delta_smooth;
     } cursor;
 
-    // currently selected paper, NULL if not present
+    // currently selected paper, id is null/stale if not present
     struct {
-        paper_t *p;
+        paper_id_t id;
         v2 offset;
         v2 init_pos;
         v2 delta;
@@ -190,22 +509,45 @@ typedef struct {
         int judges;
     } score;
 
+    // papers by g->papers index for cursor picking, its hash doubles as the
+    // paper collision broadphase. see papers_pick_sync
+    pick_index_t paper_pick;
+
+    // g->papers.gen paper_pick was last synced with
+    i32 paper_pick_gen;
+
     struct {
         v2 cur_pos;
         v2 cur_vel;
+
+        // g->cars indices bucketed by lane (CAR_RIGHT), each sorted by x
+        DYNLIST(i32) lanes[2];
     } bomb;
 
     struct {
-#define BG_WIDTH (300 / 12)
-#define BG_HEIGHT (156 / 12)
-#define BG_OFFSET (v2i_of(10, (TARGET_HEIGHT - 156) / 2))
-
         v2i player;
 
         FIXLIST(v2i, 8) cops;
         FIXLIST(v2i, 8) monies;
         FIXLIST(v2i, 8) judges;
 
+        // occupancy of the lists above
+        bribe_board_t cop_board, money_board, judge_board;
+
+        // cells nothing can enter, empty unless a level adds obstacles
+        bribe_board_t wall_board;
+
+        // BFS from the player over the wrapping grid shared by every cop,
+        // rebuilt when the player moves or dirty is set. flow is the index
+        // into bribe_dirs of a cop's next step, -1 on the player or if the
+        // player can't be reached
+        struct {
+            bool dirty;
+            v2i target;
+            i16 dist[BRIBE_BOARD_CELLS];
+            i8 flow[BRIBE_BOARD_CELLS];
+        } field;
+
         // current direction, starts as 0
         v2i dir;
 
@@ -221,26 +563,121 @@ typedef struct {
     stage_e stage;
     usize stage_ticks, stage_ticks_left;
 
+    // spawns papers/cars in the current stage
+    spawner_t spawner;
+
     struct {
         bool enabled;
         bool won;
+
+        // set once the stage's score and text are computed, cleared by
+        // set_stage
+        bool ready;
         char text[4096];
+
+        // font_size(text)
+        v2i text_size;
     } eval;
 
-    blklist_t papers;
-    blklist_t cars;
-    blklist_t bombs;
-    blklist_t particles;
+    paper_store_t papers;
+    archetype_t cars;
+    archetype_t bombs;
+    particles_t particles;
 
     bool main_menu;
     int main_menu_stage;
 } global_t;
 
+// copy of the simulation state of g (stage, score, RNG, entities) flattened
+// into one buffer, see sim_snapshot/sim_restore. neither allocates once the
+// buffer and g's entity storage have grown to fit, so snapshots can be taken
+// and restored every tick for rewind/speculative simulation.
+typedef struct {
+    DYNLIST(u8) data;
+
+    // g->time.ticks when taken
+    u64 ticks;
+} sim_snapshot_t;
+
 global_t _global;
 RELOAD_STATIC_GLOBAL(_global)
 
-global_t *g = &_global;
+// thread local so headless bot workers can each run a game in their own
+// global_t, everywhere else this only ever points at _global
+thread_local global_t *g = &_global;
+
+// pool threads for _global's g->tasks
+static task_pool_t sim_pool;
+
+// simulation task graph resources, see task.h
+enum {
+    SIM_RES_CARS      = 1 << 0,
+    SIM_RES_LANES     = 1 << 1,
+    SIM_RES_BOMBS     = 1 << 2,
+    SIM_RES_PARTICLES = 1 << 3,
+    SIM_RES_PAPERS    = 1 << 4,
+};
+
+// pool threads adopt the g of the thread running the graph
+static void sim_task_enter(void *context) {
+    g = context;
+}
+
+static void sim_run(task_graph_t *tg) {
+    task_graph_run(g->tasks, tg, g);
+}
+
+// starts sim_pool for _global, one thread per core besides the main thread
+static void sim_pool_start() {
+    task_pool_init(&sim_pool, SDL_GetCPUCount() - 1, sim_task_enter);
+    _global.tasks = &sim_pool;
+}
+
+#ifdef RELOADHOST_CLIENT_ENABLED
+// pool threads run task_pool_worker and sim_task_enter out of this module, so
+// they are stopped before it is unloaded and restarted from the new one
+static void sim_pool_pre_reload(void *) {
+    task_pool_destroy(&sim_pool);
+    _global.tasks = NULL;
+}
+
+static void sim_pool_post_reload(void *) {
+    sim_pool_start();
+}
+#endif // ifdef RELOADHOST_CLIENT_ENABLED
+
+// number of parts to split n items into, no part smaller than grain items.
+// results must never depend on this
+static int sim_parts(int n, int grain) {
+    const int threads = g->tasks ? g->tasks->n_threads + 1 : 1;
+    return clamp(n / max(grain, 1), 1, 4 * threads);
+}
+
+// [*first, *last) of n items for part of parts, boundaries are multiples of
+// align
+static void sim_range(
+    int n,
+    int align,
+    int part,
+    int parts,
+    int *first,
+    int *last) {
+    const int chunks = (n + align - 1) / align;
+    *first = ((chunks * part) / parts) * align;
+    *last = min(((chunks * (part + 1)) / parts) * align, n);
+}
+
+static void set_stage(stage_e);
+
+// how far into the next tick rendering is, in [0, 1]. tick-driven motion is
+// drawn this far between its previous and current tick's positions, so it is
+// smooth at any refresh rate at the cost of lagging up to one tick behind
+static f32 tick_alpha() {
+    return saturate((f32) g->time.tick_remainder / (f32) NS_PER_TICK);
+}
 
+#ifndef HEADLESS
+// only used while loading, hot paths use handles from g->images/g->sounds
 static const char *path_to_resource(const char *path) {
 #ifdef EMSCRIPTEN
     return mem_strfmt(thread_scratch(), "/%s", path);
@@ -249,31 +686,28 @@ static const char *path_to_resource(const char *path) {
 #endif
 }
 
-static sg_image load_image(const char *path) {
+// packs into g->image_atlas, which must be built before drawing
+static sprite_image_t load_image(const char *path) {
     v2i size;
     u8 *data;
 
     int res;
     ASSERT(!(res = image_load_rgba(path_to_resource(path), &data, &size, thread_scratch())), "%d", res);
 
-    return
-        sg_make_image(
-            &(sg_image_desc) {
-                .type = SG_IMAGETYPE_2D,
-                .usage = SG_USAGE_IMMUTABLE,
-                .pixel_format = SG_PIXELFORMAT_RGBA8,
-                .width = size.x,
-                .height = size.y,
-                .data.subimage[0][0] = { .ptr = data, .size = size.x * size.y * 4 },
-            });
+    const sprite_image_t image =
+        sprite_image_atlas_add(&g->image_atlas, data, size);
+    mem_free(thread_scratch(), data);
+    return image;
 }
 
-static void set_stage(stage_e);
-
-static void init() {
-    heap_allocator_init(&g->arena, g_mallocator);
-    bump_allocator_init(&g->frame_arena, &g->arena, 32 * 1024);
+static sound_source_t load_sound(const char *path) {
+    const sound_source_t source = sound_load(path_to_resource(path));
+    ASSERT(source != SOUND_SOURCE_NONE, "could not load %s", path);
+    return source;
+}
 
+// window, GL context, sokol, sound and all GPU resources
+static void platform_init() {
     ASSERT(
         !SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_AUDIO),
         "failed to init SDL: %s", SDL_GetError());
@@ -320,6 +754,16 @@ static void init() {
 
     SDL_GL_MakeCurrent(g->window, g->gl_ctx);
 
+    // prefer adaptive vsync (tears instead of stalling a whole refresh on a
+    // late frame), fall back to regular vsync then none
+    g->vsync =
+        !SDL_GL_SetSwapInterval(-1) || !SDL_GL_SetSwapInterval(1);
+
+    if (!g->vsync) {
+        SDL_GL_SetSwapInterval(0);
+        WARN("vsync unavailable: %s", SDL_GetError());
+    }
+
     sg_setup(
         &(sg_desc) {
             .environment.defaults = {
@@ -331,9 +775,10 @@ static void init() {
         });
     ASSERT(sg_isvalid());
 
-    input_init(&g->input, g_mallocator, g->window);
     ASSERT(sound_init(), "failed to init sound");
 
+    // all 320x180, 12 fit one page
+    sprite_image_atlas_init(&g->image_atlas, &g->arena, v2i_of(1024, 1024));
     g->images.bg_burn[0] = load_image("assets/bg_burn0.png");
     g->images.bg_burn[1] = load_image("assets/bg_burn1.png");
     g->images.bg_burn[2] = load_image("assets/bg_burn2.png");
@@ -346,6 +791,18 @@ static void init() {
     g->images.times_up = load_image("assets/times_up.png");
     g->images.caught = load_image("assets/caught.png");
     g->images.logo = load_image("assets/logo.png");
+    sprite_image_atlas_build(&g->image_atlas);
+
+    g->sounds.select = load_sound("assets/select.wav");
+    g->sounds.doc = load_sound("assets/doc.wav");
+    g->sounds.bomb = load_sound("assets/bomb.wav");
+    g->sounds.drop = load_sound("assets/drop.wav");
+    g->sounds.money = load_sound("assets/money.wav");
+    g->sounds.bribe = load_sound("assets/bribe.wav");
+    g->sounds.poor = load_sound("assets/poor.wav");
+    g->sounds.caught = load_sound("assets/caught.wav");
+    g->sounds.time = load_sound("assets/time.wav");
+    g->sounds.blip2 = load_sound("assets/blip2.wav");
 
     sprite_atlas_init(&g->atlas, path_to_resource("assets/tile.png"), v2i_of(8, 8));
     sprite_atlas_init(&g->font_atlas, path_to_resource("assets/font.png"), v2i_of(8, 8));
@@ -378,44 +835,125 @@ static void init() {
                 .colors[0].image = g->offscreen.color,
                 .depth_stencil.image = g->offscreen.depth,
             });
+}
+
+static void platform_deinit() {
+    sound_destroy();
+    sprite_image_atlas_destroy(&g->image_atlas);
+    sg_shutdown();
+    SDL_GL_DeleteContext(g->gl_ctx);
+    SDL_DestroyWindow(g->window);
+}
+#endif // ifndef HEADLESS
+
+static void init() {
+    heap_allocator_init(&g->arena, g_mallocator);
+    bump_allocator_init(&g->frame_arena, &g->arena, 32 * 1024);
+
+#ifndef HEADLESS
+    platform_init();
+#endif // ifndef HEADLESS
+
+    // g->window is NULL when headless
+    input_init(&g->input, g_mallocator, g->window);
 
     g->rand = rand_create(0x12345);
 
-    blklist_init(
-        &g->papers,
-        &g->arena,
-        32,
-        sizeof(paper_t));
+    g->time.max_ticks_per_frame = MAX_TICKS_PER_FRAME;
+
+    paper_store_init(&g->papers, &g->arena);
+
+    pick_index_init(&g->paper_pick, &g->arena, 16.0f, 4096);
 
-    blklist_init(
+    archetype_init(
         &g->cars,
         &g->arena,
         32,
-        sizeof(car_t));
+        CAR_COLUMNS,
+        (usize[]) {
+            sizeof(v2), sizeof(v2), sizeof(car_type_e), sizeof(bool)
+        });
 
-    blklist_init(
+    archetype_init(
         &g->bombs,
         &g->arena,
         32,
-        sizeof(bomb_t));
+        BOMB_COLUMNS,
+        (usize[]) { sizeof(v2), sizeof(v2), sizeof(v2) });
 
-    blklist_init(
-        &g->particles,
-        &g->arena,
-        32,
-        sizeof(particle_t));
+    for (usize i = 0; i < ARRLEN(g->bomb.lanes); i++) {
+        dynlist_init(g->bomb.lanes[i], &g->arena);
+    }
+
+    particles_init(&g->particles, &g->arena);
+
+    // bot workers init a global_t of their own on their own thread, their games
+    // run task graphs serially
+    if (g == &_global) {
+        sim_pool_start();
+
+#ifdef RELOADHOST_CLIENT_ENABLED
+        hook_register(HOOK_PRE_RELOAD, sim_pool_pre_reload, NULL);
+        hook_register(HOOK_POST_RELOAD, sim_pool_post_reload, NULL);
+#endif // ifdef RELOADHOST_CLIENT_ENABLED
+    }
 
     g->main_menu = true;
     g->main_menu_stage = 0;
     /* set_stage(STAGE_BRIBE); */
+
+#ifndef HEADLESS
+    // 0 paces to the display refresh rate
+    f64 fps = 0.0;
+
+    // game [--record <path>] [--replay <path>] [--fps <hz>]
+    //      [--stress-particles <n>]
+    char **argv = cjam_argv();
+    for (int i = 1; i + 1 < cjam_argc(); i++) {
+        if (!strcmp(argv[i], "--record")) {
+            replay_init_record(&g->replay, &g->arena, argv[i + 1]);
+        } else if (!strcmp(argv[i], "--replay")) {
+            replay_init_play(&g->replay, &g->arena, argv[i + 1]);
+        } else if (!strcmp(argv[i], "--fps")) {
+            fps = atof(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--stress-particles")) {
+            g->stress.particles = max(atoi(argv[i + 1]), 0);
+            g->stress.rand = rand_create(0x5EED);
+        }
+    }
+
+    SDL_DisplayMode mode;
+    const int refresh =
+        !SDL_GetCurrentDisplayMode(
+            max(SDL_GetWindowDisplayIndex(g->window), 0), &mode) ?
+            mode.refresh_rate
+            : 0;
+
+    if (fps <= 0.0) {
+        fps = refresh > 0 ? refresh : 60.0;
+    }
+
+    // vsync already paces swaps at the refresh rate, a limiter at or above it
+    // would only fight it
+    frame_pacer_init(
+        &g->pacer, g->vsync && refresh > 0 && fps >= refresh ? 0.0 : fps);
+
+    LOG(
+        "frame pacing: %.1f fps, vsync %s, display %dHz",
+        fps,
+        g->vsync ? "on" : "off",
+        refresh);
+#endif // ifndef HEADLESS
 }
 
 static void deinit() {
-    sound_destroy();
+    if (g->tasks) { task_pool_destroy(g->tasks); }
+    particles_destroy(&g->particles);
+    replay_destroy(&g->replay);
     input_destroy(&g->input);
-    sg_shutdown();
-    SDL_GL_DeleteContext(g->gl_ctx);
-    SDL_DestroyWindow(g->window);
+#ifndef HEADLESS
+    platform_deinit();
+#endif // ifndef HEADLESS
     heap_allocator_destroy(&g->arena);
 }
 
@@ -424,6 +962,11 @@ static void bribe_reset() {
     g->bribe.judges.n = 0;
     g->bribe.cops.n = 0;
     g->bribe.monies.n = 0;
+    g->bribe.cop_board = (bribe_board_t) { 0 };
+    g->bribe.money_board = (bribe_board_t) { 0 };
+    g->bribe.judge_board = (bribe_board_t) { 0 };
+    g->bribe.wall_board = (bribe_board_t) { 0 };
+    g->bribe.field.dirty = true;
     g->bribe.dir = v2i_of(0);
     g->bribe.caught = false;
     g->bribe.money = 0;
@@ -440,6 +983,7 @@ static void bribe_reset() {
 
         if (v2i_distance(pos, g->bribe.player) >= 3) {
             *fixlist_push(g->bribe.cops) = pos;
+            bribe_board_put(&g->bribe.cop_board, pos, true);
             n++;
         }
     }
@@ -449,20 +993,28 @@ static void set_stage(stage_e stage) {
     g->stage_ticks = 0;
     g->stage = stage;
     g->eval.enabled = false;
+    g->eval.ready = false;
 
-    blklist_clear(&g->particles);
+    particles_clear(&g->particles);
 
     switch (g->stage) {
     case STAGE_BURN:
         g->cur_paper = (typeof(g->cur_paper)) { 0 };
-        blklist_clear(&g->papers);
+        paper_store_clear(&g->papers);
         g->stage_ticks_left = STAGE_BURN_SECONDS * TICKS_PER_SECOND;
+        spawner_init(
+            &g->spawner, &g->rand, BURN_SPAWN_BASE, BURN_SPAWN_RAMP, 0.0);
         break;
     case STAGE_BOMB:
-        blklist_clear(&g->cars);
-        blklist_clear(&g->bombs);
+        archetype_clear(&g->cars);
+        dynlist_resize_no_contract(g->bomb.lanes[0], 0);
+        dynlist_resize_no_contract(g->bomb.lanes[1], 0);
+        archetype_clear(&g->bombs);
         g->stage_ticks_left = STAGE_BOMB_SECONDS * TICKS_PER_SECOND;
+        spawner_init(
+            &g->spawner, &g->rand, BOMB_SPAWN_BASE, BOMB_SPAWN_RAMP, 0.0);
         g->bomb.cur_pos = v2_of(TARGET_WIDTH / 2.0f, TARGET_HEIGHT / 2.0f);
+        g->bomb.cur_vel = v2_of(0);
         g->score.car_total = 0;
         g->score.car_civilian = 0;
         g->score.car_witness = 0;
@@ -474,18 +1026,58 @@ static void set_stage(stage_e stage) {
     }
 }
 
+// steps per second of blink_alpha
+#define BLINK_STEPS_PER_SECOND 15
+// steps per second of looping sprite animations, see anim_step
+#define ANIM_STEPS_PER_SECOND 6
+// steps per second of the main menu's bobbing logo and prompt, see menu_bob
+#define MENU_BOB_STEPS_PER_SECOND 2
+// speed of the main menu's scrolling strip, see menu_strip_offset
+#define MENU_STRIP_PX_PER_SECOND 60
+
+// alpha of blinking "press space" prompts, stepped so screens which only blink
+// can idle between steps (see idle_scene_key)
+static f32 blink_alpha() {
+    const u64 step = g->time.now / (1000000000 / BLINK_STEPS_PER_SECOND);
+    return (sinf(((f32) step / BLINK_STEPS_PER_SECOND) * PI) + 1.0f) / 2.0f;
+}
+
+// g->time.ticks or g->stage_ticks counted at per_second steps a second
+// instead of TICKS_PER_SECOND, for tick-driven animations and cadences
+static u64 tick_step(u64 ticks, u64 per_second) {
+    return ticks * per_second / TICKS_PER_SECOND;
+}
+
+// ticks to run from ticks until tick_step(ticks, per_second) next changes
+static u64 ticks_until_step(u64 ticks, u64 per_second) {
+    const u64 next = tick_step(ticks, per_second) + 1;
+    return ((next * TICKS_PER_SECOND) + per_second - 1) / per_second - ticks;
+}
+
+// step of looping sprite animations
+static u64 anim_step() {
+    return tick_step(g->time.ticks, ANIM_STEPS_PER_SECOND);
+}
+
+// 0 or 1, offset of the main menu's bobbing logo and prompt
+static int menu_bob() {
+    return tick_step(g->time.ticks, MENU_BOB_STEPS_PER_SECOND) % 2;
+}
+
+// x offset of the main menu's scrolling strip of 14px tiles
+static int menu_strip_offset() {
+    return tick_step(g->time.ticks, MENU_STRIP_PX_PER_SECOND) % 14;
+}
+
 static void main_menu_render(M_UNUSED const m4 *view, M_UNUSED const m4 *proj) {
     if (g->main_menu_stage == 0) {
-        sprite_draw_direct(
-            g->images.logo,
-            NULL,
-            v2_of(0, (g->time.ticks / 30) % 2),
+        sprite_image_batch_push_image(
+            &g->image_batch,
+            &g->images.logo,
+            v2_of(0, menu_bob()),
             0.0f,
             v4_of(1.0),
-            SPRITE_NO_FLAGS,
-            NULL,
-            view,
-            proj);
+            SPRITE_NO_FLAGS);
 
         const char *str = "PRESS SPACE TO START !";
         font_str(
@@ -493,8 +1085,8 @@ static void main_menu_render(M_UNUSED const m4 *view, M_UNUSED const m4 *proj) {
             str,
             &(font_params_t) {
                 .pos = v2_of(
-                    (TARGET_WIDTH - font_width(str)) / 2.0f,
-                    ((TARGET_HEIGHT - font_height(str)) / 2.0f) + ((g->time.ticks / 30) % 2) - 20),
+                    (TARGET_WIDTH - font_size_const(str).x) / 2.0f,
+                    ((TARGET_HEIGHT - font_size_const(str).y) / 2.0f) + menu_bob() - 20),
                 .z = 0.0f,
                 .color = v4_of(1),
                 .flags = FONT_DOUBLED,
@@ -512,14 +1104,15 @@ static void main_menu_render(M_UNUSED const m4 *view, M_UNUSED const m4 *proj) {
             "GET STARTED WITH THOSE DOCUMENTS OVER THERE.\nSEE YA ON MONDAY!\"\n\n"
             "$11(FOLLOW DIRECTIONS ON EACH SCREEN TO WIN)";
 
-        const int height = font_height(text);
+        const v2i size = font_size_const(text);
+        const int height = size.y;
         font_str(
             &g->font_batch,
             text,
             &(font_params_t) {
                 .pos =
                     v2_of(
-                        ((TARGET_WIDTH - font_width(text)) / 2.0f),
+                        ((TARGET_WIDTH - size.x) / 2.0f),
                         ((TARGET_HEIGHT - height) / 2.0f) + height + 28.0f),
                 .z = 0.0f,
                 .color = v4_of(1.0f),
@@ -528,7 +1121,7 @@ static void main_menu_render(M_UNUSED const m4 *view, M_UNUSED const m4 *proj) {
 
         {
             v4 color = palette_get(18);
-            color.a = (sinf(time_s() * PI) + 1.0f) / 2.0f;
+            color.a = blink_alpha();
             const char *str = "PRESS SPACE TO GET STARTED!";
             font_str(
                 &g->font_batch,
@@ -536,7 +1129,7 @@ static void main_menu_render(M_UNUSED const m4 *view, M_UNUSED const m4 *proj) {
                 &(font_params_t) {
                     .pos =
                         v2_of(
-                            (TARGET_WIDTH - font_width(str)) / 2.0f,
+                            (TARGET_WIDTH - font_size_const(str).x) / 2.0f,
                             20),
                     .z = 0.0f,
                     .color = color,
@@ -545,7 +1138,7 @@ static void main_menu_render(M_UNUSED const m4 *view, M_UNUSED const m4 *proj) {
         }
     }
 
-    const int offset = g->time.ticks % 14;
+    const int offset = menu_strip_offset();
     for (int i = 0; i < (TARGET_WIDTH / 14) + 2; i++) {
         sprite_batch_push_subimage(
             &g->batch,
@@ -556,16 +1149,16 @@ static void main_menu_render(M_UNUSED const m4 *view, M_UNUSED const m4 *proj) {
                 .flags = SPRITE_NO_FLAGS,
             },
             boxi_ps(
-                v2i_of(64, 16 * ((g->time.ticks / 10) % 3)),
+                v2i_of(64, 16 * (anim_step() % 3)),
                 v2i_of(12)));
     }
 }
 
 static void main_menu_update(M_UNUSED f32 dt) {
     if (input_get(&g->input, "space") & INPUT_RELEASE) {
-        rand_seed(&g->rand, SDL_GetTicks64());
+        rand_seed(&g->rand, replay_seed(&g->replay, SDL_GetTicks64()));
 
-        sound_play(path_to_resource("assets/select.wav"), NULL);
+        sound_play_source(g->sounds.select, NULL);
 
         if (g->main_menu_stage == 1) {
             g->main_menu = false;
@@ -577,17 +1170,28 @@ static void main_menu_update(M_UNUSED f32 dt) {
     }
 }
 
+// format end of stage text and measure it once
+static void eval_set_text(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(g->eval.text, sizeof(g->eval.text), fmt, args);
+    va_end(args);
+
+    g->eval.text_size = font_size(g->eval.text);
+    g->eval.ready = true;
+}
+
 static void eval_render(const m4 *view, const m4 *proj) {
     ASSERT(g->eval.enabled);
 
-    const int height = font_height(g->eval.text);
+    const int height = g->eval.text_size.y;
     font_str(
         &g->font_batch,
         g->eval.text,
         &(font_params_t) {
             .pos =
                 v2_of(
-                    (TARGET_WIDTH - font_width(g->eval.text)) / 2.0f,
+                    (TARGET_WIDTH - g->eval.text_size.x) / 2.0f,
                     ((TARGET_HEIGHT - height) / 2.0f) + height),
             .z = 0.0f,
             .color = v4_of(1.0f),
@@ -603,7 +1207,7 @@ static void eval_render(const m4 *view, const m4 *proj) {
     }
 
     v4 color = palette_get(18);
-    color.a = (sinf(time_s() * PI) + 1.0f) / 2.0f;
+    color.a = blink_alpha();
 
     font_str(
         &g->font_batch,
@@ -611,7 +1215,7 @@ static void eval_render(const m4 *view, const m4 *proj) {
          &(font_params_t) {
             .pos =
                 v2_of(
-                    (TARGET_WIDTH - font_width(guide)) / 2.0f,
+                    (TARGET_WIDTH - font_size_const(guide).x) / 2.0f,
                     10),
             .z = 0.0f,
             .color = color,
@@ -623,7 +1227,7 @@ static void eval_update(M_UNUSED f32 dt) {
     ASSERT(g->eval.enabled);
 
     if (input_get(&g->input, "space") & INPUT_RELEASE) {
-        sound_play(path_to_resource("assets/select.wav"), NULL);
+        sound_play_source(g->sounds.select, NULL);
         g->eval.enabled = false;
 
         if (g->stage == STAGE_BRIBE) {
@@ -635,10 +1239,27 @@ static void eval_update(M_UNUSED f32 dt) {
     }
 }
 
+// brings g->paper_pick up to date with g->papers. moved = false only adds
+// papers added since the last sync, otherwise every paper is moved to its
+// current position which is cheap for papers which stay in their cell
+static void papers_pick_sync(bool moved) {
+    const paper_store_t *ps = &g->papers;
+    pick_index_t *pi = &g->paper_pick;
+
+    if (g->paper_pick_gen != ps->gen || pick_index_size(pi) > ps->size) {
+        pick_index_clear(pi);
+        g->paper_pick_gen = ps->gen;
+    }
+
+    for (int i = moved ? 0 : pick_index_size(pi); i < ps->size; i++) {
+        pick_index_set(pi, i, paper_box(paper_pos(ps, i)), paper_z(i));
+    }
+}
+
 static void burn_render(const m4 *view, const m4 *proj) {
     if (g->stage_ticks_left == 0
         && (input_get(&g->input, "space") & INPUT_RELEASE)) {
-        sound_play(path_to_resource("assets/select.wav"), NULL);
+        sound_play_source(g->sounds.select, NULL);
         g->eval.enabled = true;
     }
 
@@ -650,80 +1271,81 @@ static void burn_render(const m4 *view, const m4 *proj) {
 
         v4 color = palette_get(g->stage_ticks_left == 0 ? 18 : 16);
         if (g->stage_ticks_left == 0) {
-            color.a = (sinf(time_s() * PI) + 1.0f) / 2.0f;
+            color.a = blink_alpha();
         }
 
         font_str(
             &g->font_batch,
             guide,
              &(font_params_t) {
-                .pos = v2_of((TARGET_WIDTH - font_width(guide)) / 2.0f, g->stage_ticks_left == 0 ? 2 : 10),
+                .pos = v2_of((TARGET_WIDTH - font_size_const(guide).x) / 2.0f, g->stage_ticks_left == 0 ? 2 : 10),
                 .z = 0.0f,
                 .color = color,
                 .flags = FONT_DOUBLED,
             });
     }
 
-    const paper_t *hover = g->cur_paper.p;
-    blklist_each(paper_t, &g->papers, it) {
+    // papers may have been added by ticks since the last update
+    papers_pick_sync(false);
+
+    const paper_store_t *ps = &g->papers;
+    const int hover =
+        paper_store_valid(ps, g->cur_paper.id) ?
+            g->cur_paper.id.index
+            : pick_index_top(&g->paper_pick, v2_from_i(g->input.cursor.pos));
+
+    for (int i = 0; i < ps->size; i++) {
+        const v2 pos = paper_pos(ps, i);
         v4 color = v4_of(1);
 
-        if ((!hover && boxf_contains(paper_box(it.el), v2_from_i(g->input.cursor.pos)))
-            || it.el == hover) {
+        if (i == hover) {
             color = v4_of(v3_sub(v3_from(color), v3_of(0.25f)), 1.0f);
-            hover = it.el;
         }
 
         sprite_batch_push_subimage(
             &g->batch,
             &(sprite_t) {
-                .pos = it.el->pos,
-                .z = 0.5f + (0.00001f * it.i),
+                .pos = pos,
+                .z = paper_z(i),
                 .color = color,
                 .flags = SPRITE_NO_FLAGS,
             },
             boxi_ps(
-                v2i_of(16 * it.el->type, 0),
+                v2i_of(16 * ps->type[i], 0),
                 v2i_of(16, 16)));
 
         sprite_batch_push_subimage(
             &g->batch,
             &(sprite_t) {
-                .pos = v2_add(it.el->pos, v2_of(1, -2)),
+                .pos = v2_add(pos, v2_of(1, -2)),
                 .z = 0.5f + 0.01f,
                 .color = palette_get(0),
                 .flags = SPRITE_NO_FLAGS,
             },
-            boxi_ps(v2i_of(48, (((g->time.ticks / 10) + it.i) % 3) * 8), v2i_of(16, 8)));
+            boxi_ps(v2i_of(48, ((anim_step() + i) % 3) * 8), v2i_of(16, 8)));
     }
 
-    sprite_draw_direct(
-        g->images.bg_burn[(g->time.ticks / 10) % 3],
-        NULL,
+    sprite_image_batch_push_image(
+        &g->image_batch,
+        &g->images.bg_burn[anim_step() % 3],
         v2_of(0),
         0.9f,
         v4_of(1.0),
-        SPRITE_NO_FLAGS,
-        NULL,
-        view,
-        proj);
-
-    sprite_draw_direct(
-        g->images.fg_burn,
-        NULL,
+        SPRITE_NO_FLAGS);
+
+    sprite_image_batch_push_image(
+        &g->image_batch,
+        &g->images.fg_burn,
         v2_of(0),
         0.8f,
         v4_of(1.0),
-        SPRITE_NO_FLAGS,
-        NULL,
-        view,
-        proj);
+        SPRITE_NO_FLAGS);
 }
 
 static void burn_tick() {
     if (g->stage_ticks_left == 0) { return; }
 
-    if (rand_chance(&g->rand, 0.0088f + (0.0002f * (g->stage_ticks / 60.0f)))) {
+    while (spawner_due(&g->spawner, &g->rand, g->stage_ticks * TICK_DT_S)) {
         v2 pos;
 
         if (rand_chance(&g->rand, 0.4f)) {
@@ -738,40 +1360,199 @@ static void burn_tick() {
 
         const v2 dir = v2_dir(pos, v2_of(TARGET_WIDTH / 2.0f, TARGET_HEIGHT / 2.0f));
 
-        sound_play(path_to_resource("assets/doc.wav"), NULL);
-        *blklist_add(paper_t, &g->papers) = (paper_t) {
-            .pos = pos,
-            .vel = v2_scale(dir, rand_f32(&g->rand, 80.0f, 160.0f)),
-            .type = rand_n(&g->rand, 0, 2),
-        };
+        sound_play_source(g->sounds.doc, NULL);
+        const v2 vel = v2_scale(dir, rand_f32(&g->rand, 80.0f, 160.0f));
+        paper_store_add(&g->papers, pos, vel, rand_n(&g->rand, 0, 2));
     }
 }
 
-static void burn_update(f32 dt) {
+// integrates, damps and bounces/clamps papers [first, last) on the desk,
+// SIMD_LANES papers at a time. first must be a multiple of SIMD_LANES
+static void papers_integrate(paper_store_t *ps, f32 dt, int first, int last) {
     const boxf_t desk_box = boxf_ps(v2_of(42, 30), v2_of(235, 109));
+    const v2 size = PAPER_SIZE;
+
+    const f32x4
+        vdt = f32x4_splat(dt),
+        damp = f32x4_splat(1.0f - (0.9f * dt)),
+        stop_sqr = f32x4_splat(2.0f * 2.0f),
+        bounce = f32x4_splat(-1.0f * 0.85f),
+        zero = f32x4_splat(0.0f),
+        min_x = f32x4_splat(desk_box.min.x),
+        min_y = f32x4_splat(desk_box.min.y),
+        max_x = f32x4_splat(desk_box.max.x),
+        max_y = f32x4_splat(desk_box.max.y),
+        hit_x = f32x4_splat(desk_box.max.x - 1 - size.x),
+        hit_y = f32x4_splat(desk_box.max.y - 1 - size.y),
+        clamp_x = f32x4_splat(desk_box.max.x + size.x),
+        clamp_y = f32x4_splat(desk_box.max.y + size.y);
+
+    ASSERT(first % SIMD_LANES == 0);
+
+    for (int i = first; i < min(last, ps->size); i += SIMD_LANES) {
+        f32x4
+            x = f32x4_load(&ps->x[i]),
+            y = f32x4_load(&ps->y[i]),
+            vx = f32x4_load(&ps->vx[i]),
+            vy = f32x4_load(&ps->vy[i]);
+        i32x4 inside = i32x4_load(&ps->inside[i]);
+
+        x += vx * vdt;
+        y += vy * vdt;
+        vx *= damp;
+        vy *= damp;
+
+        const i32x4 moving = ((vx * vx) + (vy * vy)) >= stop_sqr;
+        vx = (f32x4) ((i32x4) vx & moving);
+        vy = (f32x4) ((i32x4) vy & moving);
+
+        inside |= (x >= min_x) & (x <= max_x) & (y >= min_y) & (y <= max_y);
+
+        const i32x4
+            bounce_x =
+                inside
+                & (((x <= min_x) & (vx < zero)) | ((x >= hit_x) & (vx > zero))),
+            bounce_y =
+                inside
+                & (((y <= min_y) & (vy < zero)) | ((y >= hit_y) & (vy > zero)));
+
+        vx = f32x4_select(bounce_x, vx * bounce, vx);
+        vy = f32x4_select(bounce_y, vy * bounce, vy);
+        x = f32x4_select(inside, f32x4_clamp(x, min_x, clamp_x), x);
+        y = f32x4_select(inside, f32x4_clamp(y, min_y, clamp_y), y);
+
+        f32x4_store(&ps->x[i], x);
+        f32x4_store(&ps->y[i], y);
+        f32x4_store(&ps->vx[i], vx);
+        f32x4_store(&ps->vy[i], vy);
+        i32x4_store(&ps->inside[i], inside);
+    }
+}
+
+static void papers_integrate_task(void *userdata, int part, int parts) {
+    int first, last;
+    sim_range(g->papers.size, SIMD_LANES, part, parts, &first, &last);
+    papers_integrate(&g->papers, *(const f32*) userdata, first, last);
+}
+
+static int i32_cmp(const void *a, const void *b, M_UNUSED void *arg) {
+    return *(const i32*) a - *(const i32*) b;
+}
+
+// picks, integrates and collides all papers. broadphase = false collides every
+// paper against every other paper, only used to validate/benchmark.
+static void papers_step(f32 dt, int mouse_state, bool broadphase) {
+    paper_store_t *ps = &g->papers;
+    const v2 cursor = v2_from_i(g->input.cursor.pos);
+
+    papers_pick_sync(false);
+
+    if ((mouse_state & INPUT_PRESS)
+        && !paper_store_valid(ps, g->cur_paper.id)) {
+        const int i = pick_index_top(&g->paper_pick, cursor);
+
+        if (i != -1) {
+            const v2 pos = paper_pos(ps, i);
+            g->cur_paper.id = (paper_id_t) { .index = i, .gen = ps->gen };
+            g->cur_paper.offset = v2_sub(cursor, pos);
+            g->cur_paper.init_pos = pos;
+            g->cur_paper.delta = v2_of(0);
+        }
+    }
+
+    task_graph_t tg;
+    task_graph_init(&tg);
+    task_graph_add(
+        &tg,
+        &(task_t) {
+            .name = "papers integrate",
+            .f = papers_integrate_task,
+            .userdata = &dt,
+            .writes = SIM_RES_PAPERS,
+            .parts = sim_parts(ps->size, 1024),
+        });
+    sim_run(&tg);
+
+    papers_pick_sync(true);
+
+    DYNLIST(i32) near = dynlist_create(i32, thread_scratch());
+
+    for (int i = 0; i < ps->size; i++) {
+        const v2 pos = paper_pos(ps, i);
+        const boxf_t box_small = paper_box_small(pos);
+
+        // gather candidates, visited in index order to match a full scan
+        // exactly as velocities accumulate pair by pair
+        dynlist_resize_no_contract(near, 0);
+
+        if (broadphase) {
+            const v2 half = v2_scale(boxf_size(box_small), 0.5f);
+            // paper_box_small shares its center with the paper_box in
+            // g->paper_pick
+            spatial_hash_query(
+                &g->paper_pick.hash,
+                boxf_mm(
+                    v2_sub(box_small.min, v2_add(half, v2_of(1.0f))),
+                    v2_add(box_small.max, v2_add(half, v2_of(1.0f)))),
+                &near);
+            sort(near, dynlist_size(near), sizeof(i32), i32_cmp, NULL);
+        } else {
+            for (int j = 0; j < ps->size; j++) {
+                *dynlist_push(near) = j;
+            }
+        }
+
+        dynlist_each(near, it_near) {
+            const int j = *it_near.el;
+            const v2 other = paper_pos(ps, j);
+
+            if (i != j && boxf_collides(box_small, paper_box_small(other))) {
+                const v2 to_other = v2_dir(pos, other);
+                const f32 mag =
+                    min(
+                        0.6f * max(
+                            v2_norm(paper_vel(ps, i)),
+                            v2_norm(paper_vel(ps, j))),
+                        5.0f);
+                paper_set_vel(
+                    ps, i, v2_add(paper_vel(ps, i), v2_scale(to_other, -mag)));
+                paper_set_vel(
+                    ps, j, v2_add(paper_vel(ps, j), v2_scale(to_other, mag)));
+            }
+        }
+    }
+}
+
+// where papers of each type should end up, within BURN_CENTER_RADIUS
+#define BURN_CENTER_KEEP (v2_of(77, TARGET_HEIGHT - 83))
+#define BURN_CENTER_BURN (v2_of(161, TARGET_HEIGHT - 101))
+#define BURN_CENTER_IGNORE (v2_of(238, TARGET_HEIGHT - 77))
+#define BURN_CENTER_RADIUS 40.0f
 
+static void burn_update(f32 dt) {
     const v2
-        center_keep = v2_of(77, TARGET_HEIGHT - 83),
-        center_burn = v2_of(161, TARGET_HEIGHT - 101),
-        center_ignore = v2_of(238, TARGET_HEIGHT - 77);
+        center_keep = BURN_CENTER_KEEP,
+        center_burn = BURN_CENTER_BURN,
+        center_ignore = BURN_CENTER_IGNORE;
 
-    if (g->stage_ticks_left == 0) {
-        // score
+    if (g->stage_ticks_left == 0 && !g->eval.ready) {
+        // score, papers are frozen once the timer runs out
         g->score.burn_total = 0;
         g->score.burn_ignore = 0;
         g->score.burn_keep = 0;
         g->score.burn_burn = 0;
         g->score.burn_wrong = 0;
 
-        blklist_each(paper_t, &g->papers, it) {
-            const v2 c = boxf_center(paper_box(it.el));
+        for (int i = 0; i < g->papers.size; i++) {
+            const v2 c = boxf_center(paper_box(paper_pos(&g->papers, i)));
+            const paper_type_e type = g->papers.type[i];
 
-            const f32 r = 40.0f;
-            if (v2_distance(c, center_keep) < r && it.el->type == PAPER_KEEP) {
+            const f32 r = BURN_CENTER_RADIUS;
+            if (v2_distance(c, center_keep) < r && type == PAPER_KEEP) {
                 g->score.burn_keep++;
-            } else if (v2_distance(c, center_burn) < r && it.el->type == PAPER_BURN) {
+            } else if (v2_distance(c, center_burn) < r && type == PAPER_BURN) {
                 g->score.burn_burn++;
-            } else if (v2_distance(c, center_ignore) < r && it.el->type == PAPER_IGNORE) {
+            } else if (v2_distance(c, center_ignore) < r && type == PAPER_IGNORE) {
                 g->score.burn_ignore++;
             } else {
                 g->score.burn_wrong++;
@@ -780,9 +1561,7 @@ static void burn_update(f32 dt) {
             g->score.burn_total++;
         }
 
-        snprintf(
-            g->eval.text,
-            sizeof(g->eval.text),
+        eval_set_text(
             "OUT OF $31%d$09 DOCUMENTS...\n"
             "  YOU KEPT $47%d$09\n"
             "  YOU IGNORED $05%d$09\n"
@@ -795,9 +1574,11 @@ static void burn_update(f32 dt) {
             g->score.burn_ignore,
             g->score.burn_burn,
             g->score.burn_wrong);
+    }
 
+    if (g->stage_ticks_left == 0) {
         if (input_get(&g->input, "space") & INPUT_RELEASE) {
-            sound_play(path_to_resource("assets/select.wav"), NULL);
+            sound_play_source(g->sounds.select, NULL);
             g->eval.enabled = true;
         }
     }
@@ -807,73 +1588,111 @@ static void burn_update(f32 dt) {
 
     const int mouse_state = input_get(&g->input, "mouse left");
 
-    blklist_each(paper_t, &g->papers, it) {
-        if ((mouse_state & INPUT_PRESS)
-            && !g->cur_paper.p
-            && boxf_contains(paper_box(it.el), v2_from_i(g->input.cursor.pos))) {
-            g->cur_paper.p = it.el;
-            g->cur_paper.offset = v2_sub(v2_from_i(g->input.cursor.pos), it.el->pos);
-            g->cur_paper.init_pos = it.el->pos;
-            g->cur_paper.delta = v2_of(0);
-        }
-
-        it.el->pos = v2_add(it.el->pos, v2_scale(it.el->vel, dt));
-        it.el->vel = v2_scale(it.el->vel, 1.0f - (0.9f * dt));
+    papers_step(dt, mouse_state, true);
 
-        if (v2_norm(it.el->vel) < 2.0f) {
-            it.el->vel = v2_of(0.0f);
-        }
+    paper_store_t *ps = &g->papers;
+    const int cur = g->cur_paper.id.index;
 
-        const f32 restitution = 0.85f;
+    if ((mouse_state & INPUT_RELEASE) && paper_store_valid(ps, g->cur_paper.id)) {
+        paper_set_vel(
+            ps,
+            cur,
+            v2_add(
+                paper_vel(ps, cur),
+                v2_clamp_mag(
+                    v2_scale(g->cursor.delta_smooth, 45.0f), 1000.0f)));
+        g->cur_paper.id = (paper_id_t) { 0 };
+    }
 
-        if (!it.el->inside && boxf_contains(desk_box, it.el->pos)) {
-            it.el->inside = true;
-        }
+    if (paper_store_valid(ps, g->cur_paper.id)) {
+        const v2 base = v2_add(paper_pos(ps, cur), g->cur_paper.offset);
+        const v2 target = v2_from_i(g->input.cursor.pos);
+        const f32 dist = v2_distance(base, target);
+        paper_set_vel(ps, cur, v2_scale(v2_dir(base, target), 10.0f * dist));
+    }
+}
 
-        const boxf_t box = paper_box(it.el);
-        const v2 size = boxf_size(box);
+// draws cars in block between their previous and current positions by
+// *(const f32*) userdata, see tick_alpha
+static void cars_render_block(
+    archetype_t*,
+    const archetype_block_t *b,
+    void *userdata) {
+    const f32 alpha = *(const f32*) userdata;
+    const v2 *cur = archetype_column(v2, b, CAR_POS);
+    const v2 *prev = archetype_column(v2, b, CAR_PREV);
+    const car_type_e *type = archetype_column(car_type_e, b, CAR_TYPE);
+    const bool *right = archetype_column(bool, b, CAR_RIGHT);
 
-        if (it.el->inside) {
-            if ((it.el->pos.x <= desk_box.min.x && it.el->vel.x < 0)
-                || (it.el->pos.x + size.x >= desk_box.max.x - 1 && it.el->vel.x > 0)) {
-                it.el->vel.x *= -1.0f * restitution;
-            }
+    for (int j = 0; j < b->size; j++) {
+        if (!archetype_block_present(b, j)) { continue; }
 
-            if ((it.el->pos.y <= desk_box.min.y && it.el->vel.y < 0)
-                || (it.el->pos.y + size.y >= desk_box.max.y - 1 && it.el->vel.y > 0)) {
-                it.el->vel.y *= -1.0f * restitution;
-            }
+        const i32 i = b->base + j;
+        const v2 pos = v2_lerp(prev[j], cur[j], alpha);
 
-            it.el->pos = v2_clampv(it.el->pos, desk_box.min, v2_add(desk_box.max, size));
-        }
+        sprite_batch_push_subimage(
+            &g->batch,
+            &(sprite_t) {
+                .pos = v2_round(pos),
+                .z = 0.5f + (0.00001f * i),
+                .color = v4_of(1),
+                .flags = right[j] ? SPRITE_FLIP_X : SPRITE_NO_FLAGS,
+            },
+            boxi_ps(
+                v2i_of(16 * type[j], 32),
+                v2i_of(16, 16)));
 
-        const boxf_t box_small = boxf_scale_center(box, v2_of(0.6f));
-        blklist_each(paper_t, &g->papers, it2) {
-            if (it.el != it2.el
-                && boxf_collides(box_small, boxf_scale_center(paper_box(it2.el), v2_of(0.6f)))) {
-                const v2 to_other = v2_dir(it.el->pos, it2.el->pos);
-                const f32 mag =
-                    min(0.6f * max(v2_norm(it.el->vel), v2_norm(it2.el->vel)), 5.0f);
-                it.el->vel = v2_add(it.el->vel, v2_scale(to_other, -mag));
-                it2.el->vel = v2_add(it2.el->vel, v2_scale(to_other, mag));
-            }
-        }
+        sprite_batch_push_subimage(
+            &g->batch,
+            &(sprite_t) {
+                .pos = v2_add(pos, v2_of(right[j] ? 1 : -1, -2)),
+                .z = 0.5f + 0.01f,
+                .color = palette_get(0),
+                .flags = SPRITE_NO_FLAGS,
+            },
+            boxi_ps(v2i_of(48, ((anim_step() + i) % 3) * 8), v2i_of(16, 8)));
     }
+}
 
-    if ((mouse_state & INPUT_RELEASE) && g->cur_paper.p) {
-        g->cur_paper.p->vel =
-            v2_add(
-                g->cur_paper.p->vel,
-                v2_clamp_mag(
-                    v2_scale(g->cursor.delta_smooth, 45.0f), 1000.0f));
-        g->cur_paper.p = NULL;
-    }
+// draws bombs in block, interpolated as in cars_render_block
+static void bombs_render_block(
+    archetype_t*,
+    const archetype_block_t *b,
+    void *userdata) {
+    const f32 alpha = *(const f32*) userdata;
+    const v2 *cur = archetype_column(v2, b, BOMB_POS);
+    const v2 *prev = archetype_column(v2, b, BOMB_PREV);
+    const v2 *dest = archetype_column(v2, b, BOMB_DEST);
 
-    if (g->cur_paper.p) {
-        const v2 base = v2_add(g->cur_paper.p->pos, g->cur_paper.offset);
-        const v2 target = v2_from_i(g->input.cursor.pos);
-        const f32 dist = v2_distance(base, target);
-        g->cur_paper.p->vel = v2_scale(v2_dir(base, target), 10.0f * dist);
+    for (int j = 0; j < b->size; j++) {
+        if (!archetype_block_present(b, j)) { continue; }
+
+        const i32 i = b->base + j;
+        const v2 pos = v2_lerp(prev[j], cur[j], alpha);
+
+        sprite_batch_push_subimage(
+            &g->batch,
+            &(sprite_t) {
+                .pos = v2_add(v2_round(pos), v2_of(-3, 0)),
+                .z = 0.4f + (0.00001f * i),
+                .color = v4_of(1),
+                .flags = SPRITE_NO_FLAGS,
+            },
+            boxi_ps(
+                v2i_of(16 + 8 * (anim_step() % 3), 16),
+                v2i_of(8, 10)));
+
+        const f32 close = (1.0f - saturate(fabsf(pos.y - dest[j].y) / (TARGET_HEIGHT * 0.8f)));
+        const int width = 16 * close, height = 8 * close;
+        sprite_batch_push_subimage(
+            &g->batch,
+            &(sprite_t) {
+                .pos = v2_add(dest[j], v2_of(-8 + (8 - (width / 2.0f)), -2)),
+                .z = 0.6f,
+                .color = palette_get(0),
+                .flags = SPRITE_NO_FLAGS,
+            },
+            boxi_ps(v2i_of(48 + (8 - (width / 2)), ((anim_step() + i) % 3) * 8), v2i_of(width, height)));
     }
 }
 
@@ -896,91 +1715,39 @@ static void bomb_render(const m4 *view, const m4 *proj) {
 
         v4 color = palette_get(g->stage_ticks_left == 0 ? 18 : 16);
         if (g->stage_ticks_left == 0) {
-            color.a = (sinf(time_s() * PI) + 1.0f) / 2.0f;
+            color.a = blink_alpha();
         }
 
         font_str(
             &g->font_batch,
             guide,
              &(font_params_t) {
-                .pos = v2_of((TARGET_WIDTH - font_width(guide)) / 2.0f, 2),
+                .pos = v2_of((TARGET_WIDTH - font_size_const(guide).x) / 2.0f, 2),
                 .z = 0.0f,
                 .color = color,
                 .flags = FONT_DOUBLED,
             });
     }
 
-    sprite_draw_direct(
-        g->images.bg_bomb[(g->time.ticks / 10) % 3],
-        NULL,
+    sprite_image_batch_push_image(
+        &g->image_batch,
+        &g->images.bg_bomb[anim_step() % 3],
         v2_of(0),
         0.9f,
         v4_of(1.0),
-        SPRITE_NO_FLAGS,
-        NULL,
-        view,
-        proj);
-
-    sprite_draw_direct(
-        g->images.fg_bomb,
-        NULL,
+        SPRITE_NO_FLAGS);
+
+    sprite_image_batch_push_image(
+        &g->image_batch,
+        &g->images.fg_bomb,
         v2_of(0),
         0.8f,
         v4_of(1.0),
-        SPRITE_NO_FLAGS,
-        NULL,
-        view,
-        proj);
-
-    blklist_each(car_t, &g->cars, it) {
-        sprite_batch_push_subimage(
-            &g->batch,
-            &(sprite_t) {
-                .pos = v2_round(it.el->pos),
-                .z = 0.5f + (0.00001f * it.i),
-                .color = v4_of(1),
-                .flags = it.el->right ? SPRITE_FLIP_X : SPRITE_NO_FLAGS,
-            },
-            boxi_ps(
-                v2i_of(16 * it.el->type, 32),
-                v2i_of(16, 16)));
-
-        sprite_batch_push_subimage(
-            &g->batch,
-            &(sprite_t) {
-                .pos = v2_add(it.el->pos, v2_of(it.el->right ? 1 : -1, -2)),
-                .z = 0.5f + 0.01f,
-                .color = palette_get(0),
-                .flags = SPRITE_NO_FLAGS,
-            },
-            boxi_ps(v2i_of(48, (((g->time.ticks / 10) + it.i) % 3) * 8), v2i_of(16, 8)));
-    }
-
-    blklist_each(bomb_t, &g->bombs, it) {
-        sprite_batch_push_subimage(
-            &g->batch,
-            &(sprite_t) {
-                .pos = v2_add(v2_round(it.el->pos), v2_of(-3, 0)),
-                .z = 0.4f + (0.00001f * it.i),
-                .color = v4_of(1),
-                .flags = SPRITE_NO_FLAGS,
-            },
-            boxi_ps(
-                v2i_of(16 + 8 * ((g->time.ticks / 10) % 3), 16),
-                v2i_of(8, 10)));
+        SPRITE_NO_FLAGS);
 
-        const f32 close = (1.0f - saturate(fabsf(it.el->pos.y - it.el->dest.y) / (TARGET_HEIGHT * 0.8f)));
-        const int width = 16 * close, height = 8 * close;
-        sprite_batch_push_subimage(
-            &g->batch,
-            &(sprite_t) {
-                .pos = v2_add(it.el->dest, v2_of(-8 + (8 - (width / 2.0f)), -2)),
-                .z = 0.6f,
-                .color = palette_get(0),
-                .flags = SPRITE_NO_FLAGS,
-            },
-            boxi_ps(v2i_of(48 + (8 - (width / 2)), (((g->time.ticks / 10) + it.i) % 3) * 8), v2i_of(width, height)));
-    }
+    const f32 alpha = tick_alpha();
+    archetype_run(&g->cars, 0, INT32_MAX, cars_render_block, (void*) &alpha);
+    archetype_run(&g->bombs, 0, INT32_MAX, bombs_render_block, (void*) &alpha);
 
     sprite_batch_push_subimage(
         &g->batch,
@@ -995,94 +1762,420 @@ static void bomb_render(const m4 *view, const m4 *proj) {
             v2i_of(16, 16)));
 }
 
-static void bomb_tick() {
-    if (g->stage_ticks_left == 0) { return; }
+static v2 *car_pos(i32 i) {
+    return archetype_ptr(v2, &g->cars, CAR_POS, i);
+}
 
-    if (rand_chance(&g->rand, 0.035f + (0.000001f * (g->stage_ticks / 10.0f)))) {
-        v2 pos;
+static car_type_e car_type(i32 i) {
+    return *archetype_ptr(car_type_e, &g->cars, CAR_TYPE, i);
+}
 
-        const bool
-            right = rand_chance(&g->rand, 0.5f),
-            top = right;
+static bool car_right(i32 i) {
+    return *archetype_ptr(bool, &g->cars, CAR_RIGHT, i);
+}
 
-        pos.x = right ? 0.0f : TARGET_WIDTH - 2;
-        pos.y = (top ? (TARGET_HEIGHT - 109) : (TARGET_HEIGHT - 148)) + rand_f32(&g->rand, -8.0f, 8.0f);
+static f32 car_x(i32 i) {
+    return car_pos(i)->x;
+}
 
-        *blklist_add(car_t, &g->cars) = (car_t) {
-            .pos = pos,
-            .right = right,
-            .type = rand_n(&g->rand, 0, 3),
-        };
+// first position in lane with x >= x
+static int car_lane_lower_bound(DYNLIST(i32) lane, f32 x) {
+    int lo = 0, hi = dynlist_size(lane);
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (car_x(lane[mid]) < x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static void car_lane_insert(i32 i) {
+    DYNLIST(i32) *lane = &g->bomb.lanes[car_right(i)];
+    *dynlist_insert(*lane, car_lane_lower_bound(*lane, car_x(i))) = i;
+}
+
+static void car_lane_remove(i32 i) {
+    DYNLIST(i32) *lane = &g->bomb.lanes[car_right(i)];
+
+    for (int j = car_lane_lower_bound(*lane, car_x(i));
+         j < dynlist_size(*lane);
+         j++) {
+        if ((*lane)[j] == i) {
+            dynlist_remove_no_realloc(*lane, j);
+            return;
+        }
     }
 
-    blklist_each(car_t, &g->cars, it) {
-        rand_t r = rand_create(hash_add_int(0x12345, it.i));
-        it.el->pos.x += (it.el->right ? 1 : -1) * rand_f32(&r, 24.0f, 50.0f) * TICK_DT_S;
+    ASSERT(false, "car %d not in lane", i);
+}
+
+// restore x order after cars have moved, cars in a lane move at different
+// speeds but rarely pass each other so this is ~linear
+static void car_lanes_sort() {
+    for (usize l = 0; l < ARRLEN(g->bomb.lanes); l++) {
+        DYNLIST(i32) lane = g->bomb.lanes[l];
 
-        const boxf_t box = car_box(it.el);
-        const v2 size = boxf_size(box);
+        for (int i = 1; i < dynlist_size(lane); i++) {
+            const i32 id = lane[i];
+            const f32 x = car_x(id);
 
-        if (it.el->pos.x >= TARGET_WIDTH && it.el->right) {
-            blklist_remove(&g->cars, it.i);
-        } else if (it.el->pos.x + size.x <= 0 && !it.el->right) {
-            blklist_remove(&g->cars, it.i);
+            int j = i - 1;
+            while (j >= 0 && car_x(lane[j]) > x) {
+                lane[j + 1] = lane[j];
+                j--;
+            }
+            lane[j + 1] = id;
         }
     }
+}
 
-    blklist_each(bomb_t, &g->bombs, it) {
-        const f32 close = 1.0f - saturate(fabsf(it.el->pos.y - it.el->dest.y) / (TARGET_HEIGHT * 0.8f));
-        it.el->pos.y -= (80.0f + (150.0f * close)) * TICK_DT_S;
+// appends indices of cars whose center is within r of pos to *out, in index
+// order
+static void cars_query(v2 pos, f32 r, DYNLIST(i32) *out) {
+    const f32 width = boxf_size(car_box(v2_of(0))).x;
 
-        if (it.el->pos.y <= it.el->dest.y) {
-            sound_play(path_to_resource("assets/bomb.wav"), NULL);
+    const int start = dynlist_size(*out);
 
-            for (int i = 0; i < 10; i++) {
-                *blklist_add(particle_t, &g->particles) =
-                    (particle_t) {
-                        .pos = it.el->pos,
-                        .vel = v2_scale(rand_v2_dir(&g->rand), rand_f32(&g->rand, 30.0f, 50.0f)),
-                        .color = palette_get(3),
-                        .duration = 2 * TICKS_PER_SECOND,
-                    };
+    // conservative x range, exact check below
+    for (usize l = 0; l < ARRLEN(g->bomb.lanes); l++) {
+        DYNLIST(i32) lane = g->bomb.lanes[l];
+
+        for (int j = car_lane_lower_bound(lane, pos.x - r - width);
+             j < dynlist_size(lane) && car_x(lane[j]) <= pos.x + r;
+             j++) {
+            if (v2_distance(boxf_center(car_box(*car_pos(lane[j]))), pos) < r) {
+                *dynlist_push(*out) = lane[j];
             }
+        }
+    }
+
+    sort(
+        &(*out)[start],
+        dynlist_size(*out) - start,
+        sizeof(i32),
+        i32_cmp,
+        NULL);
+}
+
+// fall speed in px/s of bomb, speeds up as it nears its destination
+static f32 bomb_speed(v2 pos, v2 dest) {
+    const f32 close = 1.0f - saturate(fabsf(pos.y - dest.y) / (TARGET_HEIGHT * 0.8f));
+    return 80.0f + (150.0f * close);
+}
+
+// speed in px/s of car at index i of g->cars
+static f32 car_speed(i32 i) {
+    rand_t r = rand_create(hash_add_int(0x12345, i));
+    return rand_f32(&r, 24.0f, 50.0f);
+}
+
+// adds car and inserts it into its lane, returns its index
+static i32 car_add(v2 pos, bool right, car_type_e type) {
+    const i32 i = archetype_add(&g->cars);
+    *car_pos(i) = pos;
+    *archetype_ptr(v2, &g->cars, CAR_PREV, i) = pos;
+    *archetype_ptr(car_type_e, &g->cars, CAR_TYPE, i) = type;
+    *archetype_ptr(bool, &g->cars, CAR_RIGHT, i) = right;
+    car_lane_insert(i);
+    return i;
+}
+
+static i32 bomb_add(v2 pos, v2 dest) {
+    const i32 i = archetype_add(&g->bombs);
+    *archetype_ptr(v2, &g->bombs, BOMB_POS, i) = pos;
+    *archetype_ptr(v2, &g->bombs, BOMB_PREV, i) = pos;
+    *archetype_ptr(v2, &g->bombs, BOMB_DEST, i) = dest;
+    return i;
+}
+
+// moves cars in block, sets bit j of ((u64*) userdata)[block] for each car
+// which has left the screen
+static void cars_move_block(
+    archetype_t*,
+    const archetype_block_t *b,
+    void *userdata) {
+    u64 gone = 0;
+
+    v2 *pos = archetype_column(v2, b, CAR_POS);
+    v2 *prev = archetype_column(v2, b, CAR_PREV);
+    const bool *right = archetype_column(bool, b, CAR_RIGHT);
+    const f32 width = boxf_size(car_box(v2_of(0))).x;
+
+    for (int j = 0; j < b->size; j++) {
+        if (!archetype_block_present(b, j)) { continue; }
+
+        prev[j] = pos[j];
+        pos[j].x += (right[j] ? 1 : -1) * car_speed(b->base + j) * TICK_DT_S;
+
+        if ((pos[j].x >= TARGET_WIDTH && right[j])
+            || (pos[j].x + width <= 0 && !right[j])) {
+            gone |= 1ull << j;
+        }
+    }
+
+    ((u64*) userdata)[b->index] = gone;
+}
+
+// moves bombs in block, sets bit j of ((u64*) userdata)[block] for each bomb
+// which has landed
+static void bombs_fall_block(
+    archetype_t*,
+    const archetype_block_t *b,
+    void *userdata) {
+    u64 landed = 0;
+
+    v2 *pos = archetype_column(v2, b, BOMB_POS);
+    v2 *prev = archetype_column(v2, b, BOMB_PREV);
+    const v2 *dest = archetype_column(v2, b, BOMB_DEST);
+
+    for (int j = 0; j < b->size; j++) {
+        if (!archetype_block_present(b, j)) { continue; }
+
+        prev[j] = pos[j];
+        pos[j].y -= bomb_speed(pos[j], dest[j]) * TICK_DT_S;
+
+        if (pos[j].y <= dest[j].y) {
+            landed |= 1ull << j;
+        }
+    }
+
+    ((u64*) userdata)[b->index] = landed;
+}
+
+typedef struct {
+    // indexed = false checks every car for every bomb impact
+    bool indexed;
+
+    // per block masks from cars_move_block/bombs_fall_block
+    u64 *gone, *landed;
+
+    // bombs which landed this tick and, for each, the cars they hit in index
+    // order. hits include cars also hit by an earlier bomb
+    DYNLIST(i32) landed_bombs;
+    DYNLIST(i32) *hits;
+} cars_bombs_step_t;
+
+static void cars_move_task(void *userdata, int part, int parts) {
+    cars_bombs_step_t *step = userdata;
+
+    int first, last;
+    sim_range(archetype_block_count(&g->cars), 1, part, parts, &first, &last);
+    archetype_run(&g->cars, first, last, cars_move_block, step->gone);
+}
+
+static void bombs_fall_task(void *userdata, int part, int parts) {
+    cars_bombs_step_t *step = userdata;
+
+    int first, last;
+    sim_range(archetype_block_count(&g->bombs), 1, part, parts, &first, &last);
+    archetype_run(&g->bombs, first, last, bombs_fall_block, step->landed);
+}
+
+// finds cars hit by each landed bomb, lists are allocated on the scratch
+// allocator of the thread running each part
+static void bombs_collide_task(void *userdata, int part, int parts) {
+    cars_bombs_step_t *step = userdata;
+
+    int first, last;
+    sim_range(
+        dynlist_size(step->landed_bombs), 1, part, parts, &first, &last);
+
+    for (int k = first; k < last; k++) {
+        const v2 pos =
+            *archetype_ptr(v2, &g->bombs, BOMB_POS, step->landed_bombs[k]);
 
-            // check cars
-            blklist_each(car_t, &g->cars, it1) {
-                const v2 c = boxf_center(car_box(it1.el));
-
-                if (v2_distance(c, it.el->pos) < 10.0f) {
-                    for (int i = 0, n = rand_n(&g->rand, 8, 12); i < n; i++) {
-                        *blklist_add(particle_t, &g->particles) =
-                            (particle_t) {
-                                .pos = it1.el->pos,
-                                .vel = v2_scale(rand_v2_dir(&g->rand), rand_f32(&g->rand, 30.0f, 50.0f)),
-                                .color = palette_get(car_palette(it1.el->type)),
-                                .duration = 2 * TICKS_PER_SECOND,
-                            };
-                    }
-
-                    if (it1.el->type == CAR_RED) {
-                        g->score.car_witness++;
-                    } else {
-                        g->score.car_civilian++;
-                    }
-
-                    g->score.car_total++;
-
-                    blklist_remove(&g->cars, it1.i);
+        DYNLIST(i32) hits = dynlist_create(i32, thread_scratch());
+
+        if (step->indexed) {
+            cars_query(pos, 10.0f, &hits);
+        } else {
+            archetype_each(&g->cars, i) {
+                const v2 c = boxf_center(car_box(*car_pos(i)));
+
+                if (v2_distance(c, pos) < 10.0f) {
+                    *dynlist_push(hits) = i;
                 }
             }
+        }
+
+        step->hits[k] = hits;
+    }
+}
+
+// indices set in per block masks in index order
+static void block_masks_indices(
+    const u64 *masks,
+    int n_blocks,
+    int block_size,
+    DYNLIST(i32) *out) {
+    for (int b = 0; b < n_blocks; b++) {
+        for (u64 m = masks[b]; m; m &= m - 1) {
+            *dynlist_push(*out) = (b * block_size) + __builtin_ctzll(m);
+        }
+    }
+}
+
+// moves cars and drops bombs. indexed = false checks every car for every
+// bomb impact, only used to validate/benchmark.
+//
+// car movement and bomb falls run concurrently over blocks, then bomb impacts
+// are found concurrently per landed bomb. everything which draws from g->rand
+// or removes entities runs on this thread in index order, so results match a
+// serial run exactly.
+static void cars_bombs_step(bool indexed) {
+    const int
+        n_car_blocks = archetype_block_count(&g->cars),
+        n_bomb_blocks = archetype_block_count(&g->bombs);
+
+    ASSERT(g->cars.list.block_size <= 64 && g->bombs.list.block_size <= 64);
+
+    cars_bombs_step_t step = {
+        .indexed = indexed,
+        .gone = mem_calloc(thread_scratch(), max(n_car_blocks, 1) * sizeof(u64)),
+        .landed = mem_calloc(thread_scratch(), max(n_bomb_blocks, 1) * sizeof(u64)),
+        .landed_bombs = dynlist_create(i32, thread_scratch()),
+    };
+
+    task_graph_t tg;
+    task_graph_init(&tg);
+    task_graph_add(
+        &tg,
+        &(task_t) {
+            .name = "cars move",
+            .f = cars_move_task,
+            .userdata = &step,
+            .writes = SIM_RES_CARS,
+            .parts = sim_parts(n_car_blocks, 8),
+        });
+    task_graph_add(
+        &tg,
+        &(task_t) {
+            .name = "bombs fall",
+            .f = bombs_fall_task,
+            .userdata = &step,
+            .writes = SIM_RES_BOMBS,
+            .parts = sim_parts(n_bomb_blocks, 8),
+        });
+    sim_run(&tg);
+
+    DYNLIST(i32) gone = dynlist_create(i32, thread_scratch());
+    block_masks_indices(step.gone, n_car_blocks, g->cars.list.block_size, &gone);
+
+    dynlist_each(gone, it) {
+        // lanes are out of order until sorted below, remove by scan
+        DYNLIST(i32) *lane = &g->bomb.lanes[car_right(*it.el)];
+        dynlist_each(*lane, it_lane) {
+            if (*it_lane.el == *it.el) {
+                dynlist_remove_no_realloc(*lane, it_lane.i);
+                break;
+            }
+        }
+
+        archetype_remove(&g->cars, *it.el);
+    }
+
+    car_lanes_sort();
+
+    block_masks_indices(
+        step.landed, n_bomb_blocks, g->bombs.list.block_size, &step.landed_bombs);
+
+    const int n_landed = dynlist_size(step.landed_bombs);
+    if (n_landed == 0) { return; }
+
+    step.hits = mem_calloc(thread_scratch(), n_landed * sizeof(*step.hits));
+
+    task_graph_init(&tg);
+    task_graph_add(
+        &tg,
+        &(task_t) {
+            .name = "bombs collide",
+            .f = bombs_collide_task,
+            .userdata = &step,
+            .reads = SIM_RES_CARS | SIM_RES_LANES | SIM_RES_BOMBS,
+            .parts = sim_parts(n_landed, 4),
+        });
+    sim_run(&tg);
+
+    dynlist_each(step.landed_bombs, it) {
+        const v2 pos = *archetype_ptr(v2, &g->bombs, BOMB_POS, *it.el);
+
+        sound_play_source(g->sounds.bomb, NULL);
+
+        for (int i = 0; i < 10; i++) {
+            particles_emit(
+                &g->particles,
+                pos,
+                v2_scale(rand_v2_dir(&g->rand), rand_f32(&g->rand, 30.0f, 50.0f)),
+                palette_get(3),
+                2 * TICKS_PER_SECOND);
+        }
+
+        dynlist_each(step.hits[it.i], it_hit) {
+            const i32 i = *it_hit.el;
+
+            // already blown up by an earlier bomb this tick
+            if (!archetype_present(&g->cars, i)) { continue; }
+
+            const car_type_e type = car_type(i);
+
+            for (int k = 0, n = rand_n(&g->rand, 8, 12); k < n; k++) {
+                particles_emit(
+                    &g->particles,
+                    *car_pos(i),
+                    v2_scale(rand_v2_dir(&g->rand), rand_f32(&g->rand, 30.0f, 50.0f)),
+                    palette_get(car_palette(type)),
+                    2 * TICKS_PER_SECOND);
+            }
+
+            if (type == CAR_RED) {
+                g->score.car_witness++;
+            } else {
+                g->score.car_civilian++;
+            }
+
+            g->score.car_total++;
 
-            blklist_remove(&g->bombs, it.i);
+            car_lane_remove(i);
+            archetype_remove(&g->cars, i);
         }
+
+        archetype_remove(&g->bombs, *it.el);
+    }
+}
+
+// adds a car on a random lane, entering from its side of the screen or
+// anywhere along the road. returns its index
+static i32 cars_spawn_random(rand_t *rand, bool anywhere) {
+    const bool
+        right = rand_chance(rand, 0.5f),
+        top = right;
+
+    v2 pos;
+    pos.x =
+        anywhere ?
+            rand_f32(rand, 0.0f, TARGET_WIDTH - 2)
+            : (right ? 0.0f : TARGET_WIDTH - 2);
+    pos.y = (top ? (TARGET_HEIGHT - 109) : (TARGET_HEIGHT - 148)) + rand_f32(rand, -8.0f, 8.0f);
+
+    return car_add(pos, right, rand_n(rand, 0, 3));
+}
+
+static void bomb_tick() {
+    if (g->stage_ticks_left == 0) { return; }
+
+    while (spawner_due(&g->spawner, &g->rand, g->stage_ticks * TICK_DT_S)) {
+        cars_spawn_random(&g->rand, false);
     }
+
+    cars_bombs_step(true);
 }
 
 static void bomb_update(f32 dt) {
-    if (g->stage_ticks_left == 0) {
-        snprintf(
-            g->eval.text,
-            sizeof(g->eval.text),
+    if (g->stage_ticks_left == 0 && !g->eval.ready) {
+        eval_set_text(
             "          OUT OF $31%d$09 CARS...\n"
             "            YOU HIT $47%d$09 CIVILIANS\n"
             "            AND $15%d$09 WITNESSES\n\n"
@@ -1092,9 +2185,11 @@ static void bomb_update(f32 dt) {
             g->score.car_total,
             g->score.car_civilian,
             g->score.car_witness);
+    }
 
+    if (g->stage_ticks_left == 0) {
         if (input_get(&g->input, "space") & INPUT_RELEASE) {
-            sound_play(path_to_resource("assets/select.wav"), NULL);
+            sound_play_source(g->sounds.select, NULL);
             g->eval.enabled = true;
         }
     }
@@ -1120,11 +2215,8 @@ static void bomb_update(f32 dt) {
     }
 
     if (input_get(&g->input, "x") & INPUT_RELEASE) {
-        sound_play(path_to_resource("assets/drop.wav"), NULL);
-        *blklist_add(bomb_t, &g->bombs) = (bomb_t) {
-            .pos = v2_of(g->bomb.cur_pos.x, TARGET_HEIGHT),
-            .dest = g->bomb.cur_pos,
-        };
+        sound_play_source(g->sounds.drop, NULL);
+        bomb_add(v2_of(g->bomb.cur_pos.x, TARGET_HEIGHT), g->bomb.cur_pos);
     }
 
     g->bomb.cur_pos = v2_add(g->bomb.cur_pos, v2_scale(g->bomb.cur_vel, dt));
@@ -1141,13 +2233,13 @@ static void bribe_render(const m4 *view, const m4 *proj) {
                 : "PRESS SPACE TO RETRY...";
 
         v4 color = palette_get(18);
-        color.a = (sinf(time_s() * PI) + 1.0f) / 2.0f;
+        color.a = blink_alpha();
 
         font_str(
             &g->font_batch,
             guide,
              &(font_params_t) {
-                .pos = v2_of((TARGET_WIDTH - font_width(guide)) / 2.0f, 2),
+                .pos = v2_of((TARGET_WIDTH - font_size_const(guide).x) / 2.0f, 2),
                 .z = 0.0f,
                 .color = color,
                 .flags = FONT_DOUBLED,
@@ -1158,7 +2250,7 @@ static void bribe_render(const m4 *view, const m4 *proj) {
             &g->font_batch,
             guide,
              &(font_params_t) {
-                .pos = v2_of((TARGET_WIDTH - font_width(guide)) / 2.0f, 2),
+                .pos = v2_of((TARGET_WIDTH - font_size_const(guide).x) / 2.0f, 2),
                 .z = 0.0f,
                 .color = v4_of(1),
                 .flags = FONT_DOUBLED,
@@ -1175,7 +2267,7 @@ static void bribe_render(const m4 *view, const m4 *proj) {
             .flags = FONT_DOUBLED,
         });
 
-    const int anim = (g->time.ticks / 10) % 3;
+    const int anim = anim_step() % 3;
 
     // lives
     {
@@ -1301,183 +2393,286 @@ static void bribe_render(const m4 *view, const m4 *proj) {
                 .color = palette_get(35),
                 .flags = SPRITE_NO_FLAGS,
             },
-            boxi_ps(v2i_of(48, (((g->time.ticks / 10)) % 3) * 8), v2i_of(16, 8)));
+            boxi_ps(v2i_of(48, (anim_step() % 3) * 8), v2i_of(16, 8)));
     }
 
-    sprite_draw_direct(
-        g->images.fg_bribe,
-        NULL,
+    sprite_image_batch_push_image(
+        &g->image_batch,
+        &g->images.fg_bribe,
         v2_of(0),
         0.8f,
         v4_of(1.0),
-        SPRITE_NO_FLAGS,
-        NULL,
-        view,
-        proj);
+        SPRITE_NO_FLAGS);
 
     if (g->bribe.caught) {
-        sprite_draw_direct(
-            g->images.caught,
-            NULL,
+        sprite_image_batch_push_image(
+            &g->image_batch,
+            &g->images.caught,
             v2_of(0),
             0.0f,
             v4_of(1.0),
-            SPRITE_NO_FLAGS,
-            NULL,
-            view,
-            proj);
+            SPRITE_NO_FLAGS);
     }
 }
 
-static void bribe_tick() {
-    if (g->bribe.caught
-        || g->stage_ticks_left == 0
-        || (g->stage_ticks == 0 || (g->stage_ticks % 15) != 0)) {
-        return;
+// uniformly random cell with nothing on it and more than 4 cells from the
+// player
+static v2i bribe_free_cell() {
+    bribe_board_t free;
+
+    for (int i = 0; i < BRIBE_BOARD_WORDS; i++) {
+        free.words[i] =
+            ~(g->bribe.cop_board.words[i]
+                | g->bribe.money_board.words[i]
+                | g->bribe.judge_board.words[i]
+                | g->bribe.wall_board.words[i]);
     }
 
-    // level update 4x/second
+    // mask off past end of board
+    if (BRIBE_BOARD_CELLS % 64 != 0) {
+        free.words[BRIBE_BOARD_WORDS - 1] &=
+            (1ull << (BRIBE_BOARD_CELLS % 64)) - 1;
+    }
 
-    // money spawn
-    if (g->bribe.monies.n == 0
-        || (!fixlist_full(g->bribe.monies) && rand_chance(&g->rand, 0.055f))) {
+    for (int y = -4; y <= 4; y++) {
+        for (int x = -4; x <= 4; x++) {
+            const v2i pos = v2i_add(g->bribe.player, v2i_of(x, y));
+            if (v2i_distance(pos, g->bribe.player) <= 4) {
+                bribe_board_put(&free, pos, false);
+            }
+        }
+    }
 
-        v2i pos;
-        while (true) {
-            pos = v2i_of(rand_n(&g->rand, 0, BG_WIDTH - 1), rand_n(&g->rand, 0, BG_HEIGHT - 1));
+    return
+        bribe_board_select(
+            &free,
+            rand_n(&g->rand, 0, bribe_board_count(&free) - 1));
+}
 
-            bool ok = true;
+static const v2i bribe_dirs[4] = {
+    { .x = 1, .y = 0 },
+    { .x = -1, .y = 0 },
+    { .x = 0, .y = 1 },
+    { .x = 0, .y = -1 },
+};
 
-            fixlist_each(g->bribe.cops, it) {
-                if (v2i_eqv(pos, *it.el)) { ok = false; break; }
-            }
+M_INLINE v2i bribe_wrap(v2i pos) {
+    return
+        v2i_of(
+            ((pos.x % BG_WIDTH) + BG_WIDTH) % BG_WIDTH,
+            ((pos.y % BG_HEIGHT) + BG_HEIGHT) % BG_HEIGHT);
+}
 
-            fixlist_each(g->bribe.judges, it) {
-                if (v2i_eqv(pos, *it.el)) { ok = false; break; }
-            }
+// shortest offset from a to b on an axis of size n which wraps
+M_INLINE int bribe_wrap_delta(int a, int b, int n) {
+    int d = (b - a) % n;
+    if (d > n / 2) { d -= n; }
+    if (d < -n / 2) { d += n; }
+    return d;
+}
 
-            fixlist_each(g->bribe.monies, it) {
-                if (v2i_eqv(pos, *it.el)) { ok = false; break; }
-            }
+M_INLINE int bribe_dir_index(v2i dir) {
+    for (int i = 0; i < (int) ARRLEN(bribe_dirs); i++) {
+        if (v2i_eqv(dir, bribe_dirs[i])) { return i; }
+    }
+    return -1;
+}
 
-            ok &= v2i_distance(pos, g->bribe.player) > 4;
+// rebuilds g->bribe.field by BFS out from the player. steps are picked along
+// the longer (wrapped) axis to the player when that is a shortest path, as
+// cops did when they steered straight at the player
+static void bribe_field_update() {
+    const v2i target = g->bribe.player;
 
-            if (ok) {
-                break;
-            }
-        }
+    i16 *dist = g->bribe.field.dist;
+    i8 *flow = g->bribe.field.flow;
 
-        *fixlist_push(g->bribe.monies) = pos;
+    for (int i = 0; i < BRIBE_BOARD_CELLS; i++) {
+        dist[i] = -1;
+        flow[i] = -1;
     }
 
-    // judge spawn
-    if (g->bribe.judges.n < 2) {
-        v2i pos;
-        while (true) {
-            pos = v2i_of(rand_n(&g->rand, 0, BG_WIDTH - 1), rand_n(&g->rand, 0, BG_HEIGHT - 1));
+    i16 queue[BRIBE_BOARD_CELLS];
+    int head = 0, tail = 0;
 
-            bool ok = true;
+    dist[bribe_board_index(target)] = 0;
+    queue[tail++] = bribe_board_index(target);
 
-            fixlist_each(g->bribe.cops, it) {
-                if (v2i_eqv(pos, *it.el)) { ok = false; break; }
-            }
+    while (head < tail) {
+        const int i = queue[head++];
+        const v2i pos = v2i_of(i % BG_WIDTH, i / BG_WIDTH);
 
-            fixlist_each(g->bribe.judges, it) {
-                if (v2i_eqv(pos, *it.el)) { ok = false; break; }
-            }
+        for (int d = 0; d < (int) ARRLEN(bribe_dirs); d++) {
+            const v2i next = bribe_wrap(v2i_add(pos, bribe_dirs[d]));
+            const int j = bribe_board_index(next);
 
-            fixlist_each(g->bribe.monies, it) {
-                if (v2i_eqv(pos, *it.el)) { ok = false; break; }
+            if (dist[j] != -1 || bribe_board_get(&g->bribe.wall_board, next)) {
+                continue;
             }
 
-            ok &= v2i_distance(pos, g->bribe.player) > 4;
+            dist[j] = dist[i] + 1;
+            queue[tail++] = j;
+        }
+    }
+
+    for (int i = 0; i < BRIBE_BOARD_CELLS; i++) {
+        if (dist[i] <= 0) { continue; }
+
+        const v2i pos = v2i_of(i % BG_WIDTH, i / BG_WIDTH);
+        const v2i delta =
+            v2i_of(
+                bribe_wrap_delta(pos.x, target.x, BG_WIDTH),
+                bribe_wrap_delta(pos.y, target.y, BG_HEIGHT));
+
+        // preferred: longer axis, shorter axis, then anything downhill
+        const v2i
+            dx = v2i_of(delta.x >= 0 ? 1 : -1, 0),
+            dy = v2i_of(0, delta.y >= 0 ? 1 : -1);
+        const bool x_first = abs(delta.x) > abs(delta.y);
+
+        int order[6] = {
+            bribe_dir_index(x_first ? dx : dy),
+            bribe_dir_index(x_first ? dy : dx),
+            0, 1, 2, 3,
+        };
+
+        for (int k = 0; k < (int) ARRLEN(order); k++) {
+            const int d = order[k];
+            const v2i next = bribe_wrap(v2i_add(pos, bribe_dirs[d]));
 
-            if (ok) {
+            if (dist[bribe_board_index(next)] == dist[i] - 1) {
+                flow[i] = d;
                 break;
             }
         }
-
-        *fixlist_push(g->bribe.judges) = pos;
     }
 
-    // player move
-    if (!v2i_eqv(g->bribe.dir, v2i_of(0))) {
-        g->bribe.player = v2i_add(g->bribe.player, g->bribe.dir);
-        if (g->bribe.player.x < 0) { g->bribe.player.x = BG_WIDTH + g->bribe.player.x; }
-        if (g->bribe.player.y < 0) { g->bribe.player.y = BG_HEIGHT + g->bribe.player.y; }
-        g->bribe.player.x %= BG_WIDTH;
-        g->bribe.player.y %= BG_HEIGHT;
-    }
+    g->bribe.field.target = target;
+    g->bribe.field.dirty = false;
+}
 
-    // money get
-    fixlist_each(g->bribe.monies, it) {
-        if (v2i_eqv(*it.el, g->bribe.player)) {
-            particle_t *p;
-            *(p = blklist_add(particle_t, &g->particles)) = (particle_t) {
-                .pos =
-                    v2_add(
-                        v2_from_i(BG_OFFSET),
-                        v2_scale(
-                            v2_from_i(*it.el),
-                            12)),
-                .color = palette_get(18),
-                .is_text = true,
-                .duration = 1.5f * TICKS_PER_SECOND,
-            };
-            sound_play(path_to_resource("assets/money.wav"), NULL);
-            snprintf(p->text, sizeof(p->text), "MONEY GET!");
-            g->bribe.money++;
-            fixlist_remove_it(g->bribe.monies, it);
-        }
+static void bribe_tick() {
+    if (g->bribe.caught
+        || g->stage_ticks_left == 0
+        || g->stage_ticks == 0
+        || tick_step(g->stage_ticks, 4) == tick_step(g->stage_ticks - 1, 4)) {
+        return;
+    }
+
+    // level update 4x/second
+
+    // money spawn
+    if (g->bribe.monies.n == 0
+        || (!fixlist_full(g->bribe.monies) && rand_chance(&g->rand, 0.055f))) {
+        const v2i pos = bribe_free_cell();
+        *fixlist_push(g->bribe.monies) = pos;
+        bribe_board_put(&g->bribe.money_board, pos, true);
+    }
+
+    // judge spawn
+    if (g->bribe.judges.n < 2) {
+        const v2i pos = bribe_free_cell();
+        *fixlist_push(g->bribe.judges) = pos;
+        bribe_board_put(&g->bribe.judge_board, pos, true);
+    }
+
+    // player move
+    if (!v2i_eqv(g->bribe.dir, v2i_of(0))) {
+        const v2i next = bribe_wrap(v2i_add(g->bribe.player, g->bribe.dir));
+        if (!bribe_board_get(&g->bribe.wall_board, next)) {
+            g->bribe.player = next;
+        }
+    }
+
+    // money get
+    if (bribe_board_get(&g->bribe.money_board, g->bribe.player)) {
+        fixlist_each(g->bribe.monies, it) {
+            if (!v2i_eqv(*it.el, g->bribe.player)) { continue; }
+
+            particles_emit_text(
+                &g->particles,
+                v2_add(
+                    v2_from_i(BG_OFFSET),
+                    v2_scale(
+                        v2_from_i(*it.el),
+                        12)),
+                palette_get(18),
+                1.5f * TICKS_PER_SECOND,
+                "MONEY GET!");
+            sound_play_source(g->sounds.money, NULL);
+            g->bribe.money++;
+            fixlist_remove_it(g->bribe.monies, it);
+            bribe_board_put(&g->bribe.money_board, g->bribe.player, false);
+            break;
+        }
     }
 
     // judge bribe get
-    fixlist_each(g->bribe.judges, it) {
-        if (v2i_eqv(*it.el, g->bribe.player)) {
-            particle_t *p;
-            *(p = blklist_add(particle_t, &g->particles)) = (particle_t) {
-                .pos =
-                    v2_add(
-                        v2_from_i(BG_OFFSET),
-                        v2_scale(
-                            v2_from_i(*it.el),
-                            12)),
-                .color = g->bribe.money > 0 ? palette_get(22) : palette_get(14),
-                .is_text = true,
-                .duration = 1.5f * TICKS_PER_SECOND,
-            };
+    if (bribe_board_get(&g->bribe.judge_board, g->bribe.player)) {
+        fixlist_each(g->bribe.judges, it) {
+            if (!v2i_eqv(*it.el, g->bribe.player)) { continue; }
+
+            particles_emit_text(
+                &g->particles,
+                v2_add(
+                    v2_from_i(BG_OFFSET),
+                    v2_scale(
+                        v2_from_i(*it.el),
+                        12)),
+                g->bribe.money > 0 ? palette_get(22) : palette_get(14),
+                1.5f * TICKS_PER_SECOND,
+                g->bribe.money > 0 ? "JUDGE BRIBED!" : "TOO POOR!");
 
             if (g->bribe.money > 0) {
                 g->bribe.money--;
-                sound_play(path_to_resource("assets/bribe.wav"), NULL);
-                snprintf(p->text, sizeof(p->text), "JUDGE BRIBED!");
+                sound_play_source(g->sounds.bribe, NULL);
                 g->score.judges++;
-                fixlist_remove_it(g->bribe. judges, it);
+                fixlist_remove_it(g->bribe.judges, it);
+                bribe_board_put(&g->bribe.judge_board, g->bribe.player, false);
             } else {
-                sound_play(path_to_resource("assets/poor.wav"), NULL);
-                snprintf(p->text, sizeof(p->text), "TOO POOR!");
+                sound_play_source(g->sounds.poor, NULL);
             }
+
+            break;
         }
     }
 
-    // cops move
+    if (g->bribe.field.dirty
+        || !v2i_eqv(g->bribe.field.target, g->bribe.player)) {
+        bribe_field_update();
+    }
+
+    // cops move, cops can share cells so the board is rebuilt rather than
+    // having bits cleared from under another cop
+    g->bribe.cop_board = (bribe_board_t) { 0 };
+
     fixlist_each(g->bribe.cops, it) {
-        v2 dirf;
+        v2i dir = v2i_of(0);
 
         if (rand_chance(&g->rand, 0.16f)) {
-            dirf = rand_v2_dir(&g->rand);
+            const v2 dirf = rand_v2_dir(&g->rand);
+            dir =
+                fabsf(dirf.x) > fabsf(dirf.y) ?
+                    v2i_of(sign(dirf.x), 0)
+                    : v2i_of(0, sign(dirf.y));
         } else {
-            dirf = v2_dir(v2_from_i(*it.el), v2_from_i(g->bribe.player));
+            const int d = g->bribe.field.flow[bribe_board_index(*it.el)];
+            if (d != -1) {
+                dir = bribe_dirs[d];
+            }
         }
 
-        const v2i dir =
-            fabsf(dirf.x) > fabsf(dirf.y) ? v2i_of(sign(dirf.x), 0) : v2i_of(0, sign(dirf.y));
-        *it.el = v2i_add(*it.el, dir);
-
-        if (v2i_eqv(*it.el, g->bribe.player)) {
-            sound_play(path_to_resource("assets/caught.wav"), NULL);
-            g->bribe.caught = true;
+        const v2i next = bribe_wrap(v2i_add(*it.el, dir));
+        if (!bribe_board_get(&g->bribe.wall_board, next)) {
+            *it.el = next;
         }
+
+        bribe_board_put(&g->bribe.cop_board, *it.el, true);
+    }
+
+    if (bribe_board_get(&g->bribe.cop_board, g->bribe.player)) {
+        sound_play_source(g->sounds.caught, NULL);
+        g->bribe.caught = true;
     }
 }
 
@@ -1503,9 +2698,7 @@ static void bribe_update(M_UNUSED f32 dt) {
 
     if (done) {
         if (won) {
-            snprintf(
-                g->eval.text,
-                sizeof(g->eval.text),
+            eval_set_text(
                 "YOU MANAGED TO BRIBE $47%d$09 JUDGES...\n\n"
                 "$28\"ANOTHER DAY, ANOTHER DOLLAR!\"$09, YOUR BOSS SAYS.\n"
                 "$28\"THANKS FOR THE HELP, KIDDO. NOW GET BACK TO WORK.\"$09\n"
@@ -1526,9 +2719,7 @@ static void bribe_update(M_UNUSED f32 dt) {
                 extra = "$27\"BESIDES, YOU DIDN'T EVEN TRY THAT HARD.\"";
             }
 
-            snprintf(
-                g->eval.text,
-                sizeof(g->eval.text),
+            eval_set_text(
                 "YOUR BOSS COMES TO VISIT YOU IN JAIL...\n\n"
                 "$28\"WELL, THANKS FOR THE EFFORT\"$09, HE SAYS.\n"
                 "$28\"BUT WE JUST DON'T HAVE IT IN THE BUDGET\nTHIS QUARTER TO PAY YOUR BAIL."
@@ -1537,7 +2728,7 @@ static void bribe_update(M_UNUSED f32 dt) {
                 extra);
         }
 
-        sound_play(path_to_resource("assets/select.wav"), NULL);
+        sound_play_source(g->sounds.select, NULL);
         g->eval.enabled = true;
         g->eval.won = won;
     }
@@ -1575,23 +2766,25 @@ static void tick() {
 
     if (g->stage_ticks_left > 0 && (g->stage != STAGE_BRIBE || !g->bribe.caught)) {
         if (g->stage_ticks_left == 1) {
-            sound_play(path_to_resource("assets/time.wav"), NULL);
+            sound_play_source(g->sounds.time, NULL);
         }
 
         g->stage_ticks_left--;
 
-        int divisor;
+        // blip every second, then twice/four times a second as time runs out
+        const u64 left = g->stage_ticks_left;
+        int per_second;
 
-        if ((g->stage_ticks_left / 60) > 30) {
-            divisor = 60;
-        } else if ((g->stage_ticks_left / 30) > 15) {
-            divisor = 30;
+        if (tick_step(left, 1) > 30) {
+            per_second = 1;
+        } else if (tick_step(left, 2) > 15) {
+            per_second = 2;
         } else {
-            divisor = 15;
+            per_second = 4;
         }
 
-        if ((g->stage_ticks_left + 1) / divisor > (g->stage_ticks_left / divisor)) {
-            sound_play(path_to_resource("assets/blip2.wav"), NULL);
+        if (tick_step(left + 1, per_second) > tick_step(left, per_second)) {
+            sound_play_source(g->sounds.blip2, NULL);
         }
     }
 
@@ -1605,6 +2798,146 @@ static void tick() {
     }
 }
 
+// plain old data parts of g which the simulation touches. g->paper_pick is
+// derived from g->papers so isn't saved, sim_restore resyncs it
+#define SIM_SNAPSHOT_FIELDS(X)                                                \
+    X(g->rand)                                                                \
+    X(g->stage)                                                               \
+    X(g->stage_ticks)                                                         \
+    X(g->stage_ticks_left)                                                    \
+    X(g->spawner)                                                             \
+    X(g->score)                                                               \
+    X(g->cur_paper)                                                           \
+    X(g->bomb.cur_pos)                                                        \
+    X(g->bomb.cur_vel)                                                        \
+    X(g->bribe)                                                               \
+    X(g->eval)
+
+static void sim_snapshot_init(
+    sim_snapshot_t *s,
+    allocator_t *al,
+    usize capacity) {
+    *s = (sim_snapshot_t) { .data = dynlist_create(u8, al, capacity) };
+}
+
+static void sim_snapshot_destroy(sim_snapshot_t *s) {
+    dynlist_destroy(s->data);
+    *s = (sim_snapshot_t) { 0 };
+}
+
+static usize sim_lanes_save(void *dst) {
+    u8 *p = dst;
+    usize n = 0;
+
+    for (usize i = 0; i < ARRLEN(g->bomb.lanes); i++) {
+        const int size = dynlist_size(g->bomb.lanes[i]);
+        memput(p, &n, &size, sizeof(size));
+        memput(p, &n, g->bomb.lanes[i], size * sizeof(i32));
+    }
+
+    return n;
+}
+
+static usize sim_lanes_restore(const void *src) {
+    const u8 *p = src;
+
+    for (usize i = 0; i < ARRLEN(g->bomb.lanes); i++) {
+        int size;
+        memget(&p, &size, sizeof(size));
+
+        dynlist_resize_no_contract(g->bomb.lanes[i], size);
+        memget(&p, g->bomb.lanes[i], size * sizeof(i32));
+    }
+
+    return p - (const u8*) src;
+}
+
+// save simulation state of g to s
+static void sim_snapshot(sim_snapshot_t *s) {
+    usize size = 0;
+#define X(_f) memput(NULL, &size, &(_f), sizeof(_f));
+    SIM_SNAPSHOT_FIELDS(X)
+#undef X
+
+    size += paper_store_save(&g->papers, NULL);
+    size += archetype_save(&g->cars, NULL);
+    size += archetype_save(&g->bombs, NULL);
+    size += sim_lanes_save(NULL);
+    size += particles_save(&g->particles, NULL);
+
+    dynlist_resize_no_contract(s->data, size);
+
+    usize n = 0;
+#define X(_f) memput(s->data, &n, &(_f), sizeof(_f));
+    SIM_SNAPSHOT_FIELDS(X)
+#undef X
+
+    n += paper_store_save(&g->papers, &s->data[n]);
+    n += archetype_save(&g->cars, &s->data[n]);
+    n += archetype_save(&g->bombs, &s->data[n]);
+    n += sim_lanes_save(&s->data[n]);
+    n += particles_save(&g->particles, &s->data[n]);
+    ASSERT(n == size);
+
+    s->ticks = g->time.ticks;
+}
+
+// restore simulation state of g from s. g->time keeps running, particle
+// lifetimes are shifted so they have as long left as when s was taken
+static void sim_restore(const sim_snapshot_t *s) {
+    const u8 *p = s->data;
+#define X(_f) memget(&p, &(_f), sizeof(_f));
+    SIM_SNAPSHOT_FIELDS(X)
+#undef X
+
+    p += paper_store_restore(&g->papers, p);
+    p += archetype_restore(&g->cars, p);
+    p += archetype_restore(&g->bombs, p);
+    p += sim_lanes_restore(p);
+    p += particles_restore(&g->particles, p);
+    ASSERT(p == s->data + dynlist_size(s->data));
+
+    papers_pick_sync(true);
+
+    const u64 shift = g->time.ticks - s->ticks;
+
+    for (int i = 0; i < g->particles.size; i++) {
+        if (g->particles.spawn[i] != PARTICLE_UNSPAWNED) {
+            g->particles.spawn[i] += shift;
+        }
+    }
+
+    dynlist_each(g->particles.texts, it) {
+        if (it.el->spawn != PARTICLE_UNSPAWNED) {
+            it.el->spawn += shift;
+        }
+    }
+}
+
+static void particles_integrate_task(void *userdata, int part, int parts) {
+    int first, last;
+    sim_range(g->particles.size, SIMD_LANES, part, parts, &first, &last);
+    particles_integrate(&g->particles, *(const f32*) userdata, first, last);
+}
+
+// particles_update with integration spread over g->tasks
+static void particles_step(u64 tick, f32 dt) {
+    task_graph_t tg;
+    task_graph_init(&tg);
+    task_graph_add(
+        &tg,
+        &(task_t) {
+            .name = "particles integrate",
+            .f = particles_integrate_task,
+            .userdata = &dt,
+            .writes = SIM_RES_PARTICLES,
+            .parts = sim_parts(g->particles.size, 4096),
+        });
+    sim_run(&tg);
+
+    particles_retire(&g->particles, tick, dt);
+}
+
 static void update(f32 dt) {
     g->cursor.pos = v2_from_i(g->input.cursor.pos);
     g->cursor.delta = v2_sub(g->cursor.pos, g->cursor.last_pos);
@@ -1620,30 +2953,7 @@ static void update(f32 dt) {
         return;
     }
 
-    blklist_each(particle_t, &g->particles, it) {
-        if (!it.el->init) {
-            it.el->init = true;
-            it.el->init_pos = it.el->pos;
-            it.el->spawn = g->time.ticks;
-        }
-
-        if (it.el->is_text) {
-            it.el->pos.y += 10.0f * dt;
-        } else {
-            it.el->pos = v2_add(it.el->pos, v2_scale(it.el->vel, dt));
-            it.el->vel = v2_scale(it.el->vel, 1.0f - (0.9f * dt));
-
-            it.el->vel.y -= 20.0f * dt;
-
-            if (it.el->pos.y <= it.el->init_pos.y - 4.0f && it.el->vel.y < 0.0f) {
-                it.el->vel.y *= -0.9f;
-            }
-        }
-
-        if (g->time.ticks - it.el->spawn >= (usize) it.el->duration) {
-            blklist_remove(&g->particles, it.i);
-        }
-    }
+    particles_step(g->time.ticks, dt);
 
     switch (g->stage) {
     case STAGE_BURN: burn_update(dt); break;
@@ -1676,44 +2986,22 @@ static void render(const m4 *view, const m4 *proj) {
 
     if (g->stage_ticks_left == 0) {
         // draw time's up
-        sprite_draw_direct(
-            g->images.times_up,
-            NULL,
+        sprite_image_batch_push_image(
+            &g->image_batch,
+            &g->images.times_up,
             v2_of(0),
             0.0f,
             v4_of(1.0),
-            SPRITE_NO_FLAGS,
-            NULL,
-            view,
-            proj);
+            SPRITE_NO_FLAGS);
     }
 
-    blklist_each(particle_t, &g->particles, it) {
-        if (it.el->is_text) {
-            const int width = font_width(it.el->text);
-            font_str(
-                &g->font_batch,
-                it.el->text,
-                &(font_params_t) {
-                    .pos = v2_of(it.el->pos.x - (width / 2.0f), it.el->pos.y),
-                    .z = 0.6f + (0.0001f * it.i),
-                    .color = it.el->color,
-                    .flags = FONT_DOUBLED,
-                });
-        } else {
-            sprite_batch_push_subimage(
-                &g->batch,
-                &(sprite_t) {
-                    .pos = it.el->pos,
-                    .z = 0.6f + (0.0001f * it.i),
-                    .color = it.el->color,
-                    .flags = SPRITE_NO_FLAGS,
-                },
-                boxi_ps(
-                    v2i_of(40, 16),
-                    v2i_of(1, 1)));
-        }
-    }
+    // particles stay within [0.6, 0.7) however many there are
+    particles_render(
+        &g->particles,
+        &g->batch,
+        &g->font_batch,
+        0.6f,
+        min(0.0001f, 0.1f / max(particles_count(&g->particles), 1)));
 
     switch (g->stage) {
     case STAGE_BURN: burn_render(view, proj); return;
@@ -1723,103 +3011,1661 @@ static void render(const m4 *view, const m4 *proj) {
     }
 }
 
-static void frame() {
-    bump_allocator_reset(&g->frame_arena, 32 * 1024);
+// number of ticks owed for a frame which took delta_ns, at most
+// g->time.max_ticks_per_frame. updates tick_remainder and overrun accounting.
+static usize frame_ticks(u64 delta_ns) {
+    u64 tick_ns = delta_ns + g->time.tick_remainder;
 
-    static u64 last_frame = 0, delta = 0;
-    const u64 now = time_ns();
-    delta = now - last_frame;
-    last_frame = now;
+    usize n = 0;
+    while (tick_ns > NS_PER_TICK && n < g->time.max_ticks_per_frame) {
+        tick_ns -= NS_PER_TICK;
+        n++;
+    }
 
-    g->time.now = now;
-    g->time.now_s = NS_TO_SECS(now);
-    g->time.dt_s = NS_TO_SECS(delta);
+    if (tick_ns > NS_PER_TICK) {
+        // a stall (asset load, debugger, ...) would otherwise spiral: drop
+        // whole owed ticks but keep the phase so pacing stays smooth
+        g->time.dropped_ticks += tick_ns / NS_PER_TICK;
+        g->time.overrun_frames++;
+        tick_ns %= NS_PER_TICK;
+    }
 
-    if ((g->time.now - g->time.last_second) >= 1000000000) {
-        g->time.last_second = now;
-        g->time.fps = g->time.second_frames;
-        g->time.second_frames = 0;
-        g->time.tps = g->time.second_ticks;
-        g->time.second_ticks = 0;
+    g->time.coalesced_ticks += n > 1 ? n - 1 : 0;
+    g->time.tick_remainder = tick_ns;
+    return n;
+}
 
-        LOG("fps: %" PRIu64 " / tps: %" PRIu64, g->time.fps, g->time.tps);
+// runs update() and the ticks owed for a frame which took delta_ns, the only
+// part of a frame which affects the simulation
+static void frame_step(u64 delta_ns) {
+    // variable step is bounded the same way as fixed step
+    update(
+        min(NS_TO_SECS(delta_ns), g->time.max_ticks_per_frame * TICK_DT_S));
+
+    const usize n_ticks = frame_ticks(delta_ns);
+    for (usize i = 0; i < n_ticks; i++) {
+        tick();
+        g->time.ticks++;
+        g->time.second_ticks++;
     }
+}
 
-    SDL_GL_SetSwapInterval(0);
+#ifndef HEADLESS
+// hash of everything drawn by screens which only change on input or at known
+// times (main menu, evaluation), 0 if the current screen can change at any
+// time and must always be drawn
+static hash_t idle_scene_key() {
+    if (g->replay.mode == REPLAY_PLAY || g->stress.particles != 0) {
+        return 0;
+    }
 
-    v2i window_size;
-    SDL_GetWindowSize(g->window, &window_size.x, &window_size.y);
+    const u64 blink = g->time.now / (1000000000 / BLINK_STEPS_PER_SECOND);
 
-    input_update(
-        &g->input,
-        time_ns(),
-        window_size,
-        v2i_of(TARGET_WIDTH, TARGET_HEIGHT));
+    if (g->main_menu) {
+        // the strip scrolls and animates on both stages, the first bobs and the
+        // second blinks
+        hash_t h = hash_add_int(0x12345, g->main_menu_stage);
+        h = hash_add_int(h, menu_strip_offset());
+        h = hash_add_u64(h, anim_step() % 3);
+        return g->main_menu_stage == 0 ?
+            hash_add_int(h, menu_bob())
+            : hash_add_u64(h, blink);
+    }
 
-    SDL_Event ev;
-    while (SDL_PollEvent(&ev)) {
-        switch (ev.type) {
-        case SDL_QUIT:
-            cjam_quit();
-            break;
+    if (g->eval.enabled) {
+        hash_t h = hash_add_int(0x54321, g->stage);
+        h = hash_add_int(h, g->eval.won);
+        h = hash_add_str(h, g->eval.text);
+        return hash_add_u64(h, blink);
+    }
+
+    return 0;
+}
+
+// ns until idle_scene_key() next changes without input
+static u64 idle_wait_ns() {
+    const u64 now = time_ns(), step = 1000000000 / BLINK_STEPS_PER_SECOND;
+    u64 wait = step - (now % step);
+
+    if (g->main_menu) {
+        u64 ticks =
+            min(ticks_until_step(g->time.ticks, MENU_STRIP_PX_PER_SECOND),
+                ticks_until_step(g->time.ticks, ANIM_STEPS_PER_SECOND));
+
+        if (g->main_menu_stage == 0) {
+            // bobs instead of blinking
+            ticks = min(ticks, ticks_until_step(g->time.ticks, MENU_BOB_STEPS_PER_SECOND));
+            wait = U64_MAX;
         }
 
-        input_process(&g->input, &ev);
+        // time owed towards those ticks, see frame_ticks
+        const u64
+            owed = g->time.tick_remainder + (now - g->time.now),
+            until = ticks * NS_PER_TICK;
+        wait = min(wait, owed >= until ? 0 : until - owed);
     }
 
-    sprite_batch_init(&g->batch, &g->frame_arena, &g->atlas);
-    sprite_batch_init(&g->font_batch, &g->frame_arena, &g->font_atlas);
+    return wait;
+}
+
+// tops particles up to g->stress.particles, which all draw every frame
+static void stress_step() {
+    rand_t *rand = &g->stress.rand;
+
+    while (particles_count(&g->particles) < g->stress.particles) {
+        particles_emit(
+            &g->particles,
+            rand_v2(rand, v2_of(0), v2_of(TARGET_WIDTH, TARGET_HEIGHT)),
+            v2_scale(rand_v2_dir(rand), rand_f32(rand, 10.0f, 50.0f)),
+            palette_get(rand_n(rand, 1, 40)),
+            rand_n(rand, TICKS_PER_SECOND / 2, 4 * TICKS_PER_SECOND));
+    }
+}
+#endif // ifndef HEADLESS
+
+#ifdef HEADLESS
+static const char *stage_name(stage_e stage) {
+    switch (stage) {
+    case STAGE_BURN: return "burn";
+    case STAGE_BOMB: return "bomb";
+    case STAGE_BRIBE: return "bribe";
+    }
+
+    return "?";
+}
+
+// hash of simulation state, must not change across optimizations
+static hash_t headless_checksum() {
+    hash_t h = hash_add_u64(0x12345, g->rand.s[0]);
+
+    for (int i = 0; i < g->papers.size; i++) {
+        h = hash_add_v2(h, paper_pos(&g->papers, i));
+        h = hash_add_v2(h, paper_vel(&g->papers, i));
+    }
+
+    archetype_each(&g->cars, i) {
+        h = hash_add_v2(h, *car_pos(i));
+    }
+
+    archetype_each(&g->bombs, i) {
+        h = hash_add_v2(h, *archetype_ptr(v2, &g->bombs, BOMB_POS, i));
+    }
 
-    update(g->time.dt_s);
+    for (int i = 0; i < g->particles.size; i++) {
+        h = hash_add_v2(h, v2_of(g->particles.x[i], g->particles.y[i]));
+    }
+
+    dynlist_each(g->particles.texts, it) {
+        h = hash_add_v2(h, it.el->pos);
+    }
+
+    h = hash_add_v2i(h, g->bribe.player);
+    fixlist_each(g->bribe.cops, it) { h = hash_add_v2i(h, *it.el); }
+    fixlist_each(g->bribe.monies, it) { h = hash_add_v2i(h, *it.el); }
+    fixlist_each(g->bribe.judges, it) { h = hash_add_v2i(h, *it.el); }
+
+    return h;
+}
+
+// runs update()/tick() for n fixed steps on stage with no window, GL context or
+// sokol. the stage is restarted whenever it ends so every step measures live
+// simulation work.
+static void headless_run(stage_e stage, usize n, u64 seed) {
+    rand_seed(&g->rand, seed);
+    g->time.ticks = 0;
+    g->main_menu = false;
+    set_stage(stage);
+
+    const u64 start = time_ns();
+
+    for (usize i = 0; i < n; i++) {
+        bump_allocator_reset(&g->frame_arena, 32 * 1024);
+        bump_allocator_reset(thread_scratch(), 1 * 1024 * 1024);
+
+        if (g->stage_ticks_left == 0
+            || g->eval.enabled
+            || (g->stage == STAGE_BRIBE && g->bribe.caught)) {
+            set_stage(stage);
+        }
 
-    u64 tick_ns = delta + g->time.tick_remainder;
-    while (tick_ns > NS_PER_TICK) {
+        input_update(
+            &g->input,
+            g->time.ticks * NS_PER_TICK,
+            v2i_of(TARGET_WIDTH, TARGET_HEIGHT),
+            v2i_of(TARGET_WIDTH, TARGET_HEIGHT));
+
+        update(TICK_DT_S);
         tick();
-        tick_ns -= NS_PER_TICK;
 
         g->time.ticks++;
-        g->time.second_ticks++;
     }
-    g->time.tick_remainder = tick_ns;
 
+    const f64 elapsed_s = NS_TO_SECS(time_ns() - start);
 
-    v4 clear_color = palette_get(0);
+    LOG(
+        "%-5s: %" PRIusize " ticks in %.3fs, %.1f ticks/s (state %016" PRIx64 ")",
+        stage_name(stage),
+        n,
+        elapsed_s,
+        n / elapsed_s,
+        headless_checksum());
+}
 
-    if (g->main_menu) {
-        clear_color = palette_get(3);
-    } else {
-        switch (g->stage) {
-        case STAGE_BURN: clear_color = palette_get(0); break;
-        case STAGE_BOMB: clear_color = palette_get(29); break;
-        case STAGE_BRIBE: clear_color = palette_get(36); break;
-          break;
+// a benchmark of an optimised implementation against a reference one which
+// must end in the same state, see headless_compare
+typedef struct {
+    // logged, e.g. "1000 papers"
+    const char *label;
+
+    // logged names of pass 0 (optimised) and pass 1 (reference)
+    const char *names[2];
+
+    // what a step is, e.g. "frame", and steps per pass
+    const char *unit;
+    int steps;
+
+    // builds the starting state of a pass from g->rand, untimed
+    void (*setup)(void *userdata, int pass);
+
+    // runs before each step, untimed. can be NULL
+    void (*prepare)(void *userdata, int pass, int step);
+
+    // one timed step of pass
+    void (*step)(void *userdata, int pass, int step);
+
+    // hash of the state a pass ends in
+    hash_t (*checksum)(void *userdata);
+
+    void *userdata;
+} headless_compare_t;
+
+// runs both passes of c with g->rand seeded to seed and logs their time per
+// step, with MISMATCH if they end in different states. returns true if they
+// match
+static bool headless_compare(const headless_compare_t *c, u64 seed) {
+    f64 step_s[2];
+    hash_t check[2];
+
+    for (int pass = 0; pass < 2; pass++) {
+        rand_seed(&g->rand, seed);
+        c->setup(c->userdata, pass);
+
+        u64 elapsed = 0;
+
+        for (int i = 0; i < c->steps; i++) {
+            bump_allocator_reset(thread_scratch(), 1 * 1024 * 1024);
+
+            if (c->prepare) { c->prepare(c->userdata, pass, i); }
+
+            const u64 start = time_ns();
+            c->step(c->userdata, pass, i);
+            elapsed += time_ns() - start;
         }
+
+        step_s[pass] = NS_TO_SECS(elapsed) / c->steps;
+        check[pass] = c->checksum(c->userdata);
     }
 
-    sg_begin_pass(
-        &(sg_pass) {
-            .attachments = g->offscreen.attachments,
-            .action = {
-                .colors[0] = {
-                    .load_action = SG_LOADACTION_CLEAR,
-                    .clear_value = { clear_color.r, clear_color.g, clear_color.b, 1.0f },
-                },
-                .depth = {
-                    .load_action = SG_LOADACTION_CLEAR,
-                    .clear_value = 1.0f,
-                },
+    LOG(
+        "%s: %s %.3fms/%s, %s %.3fms/%s (%.1fx)%s",
+        c->label,
+        c->names[0],
+        step_s[0] * 1000.0,
+        c->unit,
+        c->names[1],
+        step_s[1] * 1000.0,
+        c->unit,
+        step_s[1] / step_s[0],
+        check[0] == check[1] ? "" : " MISMATCH");
+
+    return check[0] == check[1];
+}
+
+// papers spread at constant density over a square of extent
+typedef struct {
+    int n;
+    f32 extent;
+} headless_papers_t;
+
+static void headless_papers_setup(void *userdata, M_UNUSED int pass) {
+    const headless_papers_t *hp = userdata;
+
+    set_stage(STAGE_BURN);
+
+    for (int j = 0; j < hp->n; j++) {
+        const v2 pos = rand_v2(&g->rand, v2_of(0), v2_of(hp->extent));
+        const v2 vel =
+            v2_scale(
+                rand_v2_dir(&g->rand),
+                rand_f32(&g->rand, 20.0f, 160.0f));
+        paper_store_add(&g->papers, pos, vel, rand_n(&g->rand, 0, 2));
+    }
+}
+
+static void headless_papers_step(
+    M_UNUSED void *userdata,
+    int pass,
+    M_UNUSED int step) {
+    papers_step(TICK_DT_S, 0, pass == 0);
+}
+
+static hash_t headless_papers_checksum(M_UNUSED void *userdata) {
+    hash_t h = 0x12345;
+    for (int j = 0; j < g->papers.size; j++) {
+        h = hash_add_v2(h, paper_pos(&g->papers, j));
+        h = hash_add_v2(h, paper_vel(&g->papers, j));
+    }
+    return h;
+}
+
+// paper collisions with the broadphase and cursor picks with the pick index vs.
+// full scans at increasing paper counts, papers are spread at constant density.
+// end states and picks must match.
+static void headless_bench_papers(u64 seed) {
+    static const int counts[] = { 100, 1000, 10000 };
+
+    for (usize i = 0; i < ARRLEN(counts); i++) {
+        const int n = counts[i];
+
+        headless_papers_t hp = { .n = n, .extent = sqrtf(n) * 20.0f };
+
+        char label[32];
+        snprintf(label, sizeof(label), "%5d papers", n);
+
+        headless_compare(
+            &(headless_compare_t) {
+                .label = label,
+                .names = { "broadphase", "full scan" },
+                .unit = "frame",
+                .steps = n >= 10000 ? 5 : 60,
+                .setup = headless_papers_setup,
+                .step = headless_papers_step,
+                .checksum = headless_papers_checksum,
+                .userdata = &hp,
             },
-        });
-    {
-        const m4
-            view = m4_identity(),
-            proj =
-                cam_ortho(
-                    0.0f, TARGET_WIDTH, 0.0f, TARGET_HEIGHT, 1.0f, -1.0f);
-        render(&view, &proj);
+            seed);
+
+        // cursor picks against the final state, the first paper under the
+        // point in a full scan is the topmost
+        const int picks = 10000;
+        u64 pick_ns[2] = { 0, 0 };
+        int mismatches = 0;
+
+        for (int j = 0; j < picks; j++) {
+            const v2 p = rand_v2(&g->rand, v2_of(0), v2_of(hp.extent));
+
+            u64 start = time_ns();
+            const int top = pick_index_top(&g->paper_pick, p);
+            pick_ns[0] += time_ns() - start;
+
+            start = time_ns();
+            int first = -1;
+            for (int k = 0; k < g->papers.size; k++) {
+                if (boxf_contains(paper_box(paper_pos(&g->papers, k)), p)) {
+                    first = k;
+                    break;
+                }
+            }
+            pick_ns[1] += time_ns() - start;
 
-        sprite_batch_draw(&g->font_batch, NULL, &view, &proj);
-        sprite_batch_draw(&g->batch, NULL, &view, &proj);
+            mismatches += top != first;
+        }
+
+        LOG(
+            "%5d papers: pick index %.3fus/pick, full scan %.3fus/pick%s",
+            n,
+            (pick_ns[0] / 1000.0) / picks,
+            (pick_ns[1] / 1000.0) / picks,
+            mismatches == 0 ? "" : " MISMATCH");
+    }
+}
+
+// particle update + sprite emission at increasing particle counts, a fresh
+// wave of n particles is emitted whenever the previous one has retired
+static void headless_bench_particles(u64 seed) {
+    static const int counts[] = { 1000, 10000, 50000 };
+    const int frames = 600;
+
+    for (usize i = 0; i < ARRLEN(counts); i++) {
+        const int n = counts[i];
+
+        rand_seed(&g->rand, seed);
+        particles_clear(&g->particles);
+
+        u64 emitted = 0, drawn = 0;
+        const u64 start = time_ns();
+
+        for (int f = 0; f < frames; f++) {
+            bump_allocator_reset(&g->frame_arena, 32 * 1024);
+            sprite_batch_init(&g->batch, &g->frame_arena, &g->atlas);
+            sprite_batch_init(&g->font_batch, &g->frame_arena, &g->font_atlas);
+
+            if (particles_count(&g->particles) == 0) {
+                for (int j = 0; j < n; j++) {
+                    particles_emit(
+                        &g->particles,
+                        rand_v2(
+                            &g->rand,
+                            v2_of(0),
+                            v2_of(TARGET_WIDTH, TARGET_HEIGHT)),
+                        v2_scale(
+                            rand_v2_dir(&g->rand),
+                            rand_f32(&g->rand, 30.0f, 50.0f)),
+                        palette_get(3),
+                        rand_n(&g->rand, 30, 120));
+                }
+
+                emitted += n;
+            }
+
+            particles_update(&g->particles, f, TICK_DT_S);
+            particles_render(
+                &g->particles, &g->batch, &g->font_batch, 0.6f, 0.0f);
+            drawn += dynlist_size(g->batch.sprites);
+        }
+
+        const f64 frame_s = NS_TO_SECS(time_ns() - start) / frames;
+
+        LOG(
+            "%5d particles: %.3fms/frame (%" PRIu64 " emitted, %" PRIu64 " drawn)",
+            n,
+            frame_s * 1000.0,
+            emitted,
+            drawn);
+    }
+
+    particles_clear(&g->particles);
+}
+
+// sprite_batch_sort of a full chunk (SPRITE_CHUNK_INSTANCES) laid out like a
+// frame: layers of sprites at fixed z with per sprite z offsets, some
+// translucent. the result must be in draw order
+static void headless_bench_sprites(u64 seed) {
+    const int n = 65536, frames = 200;
+
+    rand_seed(&g->rand, seed);
+
+    u64 elapsed = 0;
+    int unordered = 0;
+
+    for (int f = 0; f < frames; f++) {
+        bump_allocator_reset(&g->frame_arena, 32 * 1024);
+        bump_allocator_reset(thread_scratch(), 1 * 1024 * 1024);
+        sprite_batch_init(&g->batch, &g->frame_arena, &g->atlas);
+
+        for (int i = 0; i < n; i++) {
+            const f32 layer = 0.3f + (0.1f * rand_n(&g->rand, 0, 5));
+
+            sprite_batch_push_subimage(
+                &g->batch,
+                &(sprite_t) {
+                    .pos = rand_v2(
+                        &g->rand,
+                        v2_of(0),
+                        v2_of(TARGET_WIDTH, TARGET_HEIGHT)),
+                    .z = layer + (0.00001f * rand_n(&g->rand, 0, 999)),
+                    .color =
+                        v4_of(1.0f, 1.0f, 1.0f,
+                            rand_chance(&g->rand, 0.25f) ? 0.5f : 1.0f),
+                    .flags = SPRITE_NO_FLAGS,
+                },
+                boxi_ps(v2i_of(0), v2i_of(8)));
+        }
+
+        const u64 start = time_ns();
+        sprite_batch_sort(&g->batch);
+        elapsed += time_ns() - start;
+
+        // opaque then translucent, each back to front
+        const sprite_batch_t *b = &g->batch;
+        for (int i = 1; i < n; i++) {
+            const sprite_instance_t *p = &b->sprites[i - 1], *q = &b->sprites[i];
+            const bool pass_p = i - 1 >= b->n_opaque, pass_q = i >= b->n_opaque;
+
+            if (pass_p != pass_q ? pass_p : p->z < q->z) {
+                unordered++;
+            }
+        }
+    }
+
+    LOG(
+        "%d sprites: sort %.3fms/frame%s",
+        n,
+        NS_TO_SECS(elapsed) * 1000.0 / frames,
+        unordered == 0 ? "" : " UNORDERED");
+}
+
+// skyline packing of random rectangles into 1024x1024 pages until they are
+// full. placements must be in bounds and not overlap
+static void headless_bench_pack(u64 seed) {
+    const int pages = 100, max_misses = 32;
+    const v2i page_size = v2i_of(1024, 1024);
+
+    rand_seed(&g->rand, seed);
+
+    skyline_t sky;
+    skyline_init(&sky, &g->arena, page_size);
+
+    DYNLIST(boxi_t) placed = dynlist_create(boxi_t, &g->arena);
+
+    u64 elapsed = 0, inserts = 0;
+    f64 occupancy = 0.0;
+    int bad = 0;
+
+    for (int p = 0; p < pages; p++) {
+        skyline_clear(&sky);
+        dynlist_resize_no_contract(placed, 0);
+
+        for (int misses = 0; misses < max_misses;) {
+            const v2i size =
+                v2i_of(rand_n(&g->rand, 4, 128), rand_n(&g->rand, 4, 128));
+
+            v2i pos;
+            const u64 start = time_ns();
+            const bool fit = skyline_insert(&sky, size, &pos);
+            elapsed += time_ns() - start;
+            inserts++;
+
+            if (!fit) {
+                misses++;
+                continue;
+            }
+
+            // half open, [min, max)
+            const boxi_t box = { .min = pos, .max = v2i_add(pos, size) };
+
+            if (box.min.x < 0 || box.min.y < 0
+                || box.max.x > page_size.x || box.max.y > page_size.y) {
+                bad++;
+            }
+
+            dynlist_each(placed, it) {
+                if (box.min.x < it.el->max.x && it.el->min.x < box.max.x
+                    && box.min.y < it.el->max.y && it.el->min.y < box.max.y) {
+                    bad++;
+                }
+            }
+
+            *dynlist_push(placed) = box;
+        }
+
+        occupancy += skyline_occupancy(&sky);
+    }
+
+    LOG(
+        "%d pages: %.3fus/insert, %.1f%% occupancy%s",
+        pages,
+        NS_TO_SECS(elapsed) * 1000000.0 / inserts,
+        100.0 * occupancy / pages,
+        bad == 0 ? "" : " OVERLAP");
+
+    dynlist_destroy(placed);
+    skyline_destroy(&sky);
+}
+
+// cars kept topped up to n, with a burst of bombs landing every tick
+typedef struct {
+    int n, bombs_per_tick;
+} headless_cars_t;
+
+static void headless_cars_setup(M_UNUSED void *userdata, M_UNUSED int pass) {
+    set_stage(STAGE_BOMB);
+}
+
+static void headless_cars_prepare(
+    void *userdata,
+    M_UNUSED int pass,
+    M_UNUSED int step) {
+    const headless_cars_t *hc = userdata;
+
+    particles_clear(&g->particles);
+
+    while (archetype_size(&g->cars) < hc->n) {
+        cars_spawn_random(&g->rand, true);
+    }
+
+    for (int j = 0; j < hc->bombs_per_tick; j++) {
+        const v2 pos =
+            v2_of(
+                rand_f32(&g->rand, 0.0f, TARGET_WIDTH),
+                rand_f32(&g->rand, TARGET_HEIGHT - 160, TARGET_HEIGHT - 95));
+        bomb_add(pos, pos);
+    }
+}
+
+static void headless_cars_step(
+    M_UNUSED void *userdata,
+    int pass,
+    M_UNUSED int step) {
+    cars_bombs_step(pass == 0);
+}
+
+static hash_t headless_cars_checksum(M_UNUSED void *userdata) {
+    hash_t h = hash_add_int(0x12345, g->score.car_total);
+    archetype_each(&g->cars, i) {
+        h = hash_add_int(h, i);
+        h = hash_add_v2(h, *car_pos(i));
+    }
+    return h;
+}
+
+// bomb impacts against cars with the lane index vs. a full scan at increasing
+// car counts. cars are topped back up to n every tick and a burst of bombs
+// lands on the road every tick. end states must match.
+static void headless_bench_cars(u64 seed) {
+    static const int counts[] = { 100, 1000, 10000 };
+
+    for (usize i = 0; i < ARRLEN(counts); i++) {
+        const int n = counts[i];
+
+        headless_cars_t hc = { .n = n, .bombs_per_tick = 8 };
+
+        char label[32];
+        snprintf(label, sizeof(label), "%5d cars", n);
+
+        headless_compare(
+            &(headless_compare_t) {
+                .label = label,
+                .names = { "lanes", "full scan" },
+                .unit = "tick",
+                .steps = 120,
+                .setup = headless_cars_setup,
+                .prepare = headless_cars_prepare,
+                .step = headless_cars_step,
+                .checksum = headless_cars_checksum,
+                .userdata = &hc,
+            },
+            seed);
+    }
+
+    particles_clear(&g->particles);
+}
+
+// both passes start from the snapshot in userdata
+static void headless_snapshot_setup(void *userdata, M_UNUSED int pass) {
+    sim_restore(userdata);
+}
+
+static void headless_snapshot_step(
+    M_UNUSED void *userdata,
+    M_UNUSED int pass,
+    M_UNUSED int step) {
+    particles_update(&g->particles, g->time.ticks, TICK_DT_S);
+    tick();
+    g->time.ticks++;
+}
+
+static hash_t headless_snapshot_checksum(M_UNUSED void *userdata) {
+    return headless_checksum();
+}
+
+// snapshot/restore latency with n papers, cars and bombs and 4n particles.
+// also checks that ticks run after a restore reproduce those run after the
+// snapshot was taken
+static void headless_bench_snapshot(u64 seed) {
+    static const int counts[] = { 100, 1000, 10000 };
+    const int iters = 200, ticks = 60;
+
+    sim_snapshot_t s;
+    sim_snapshot_init(&s, &g->arena, 64 * 1024);
+
+    for (usize i = 0; i < ARRLEN(counts); i++) {
+        const int n = counts[i];
+
+        rand_seed(&g->rand, seed);
+        set_stage(STAGE_BOMB);
+        paper_store_clear(&g->papers);
+        particles_clear(&g->particles);
+
+        for (int j = 0; j < n; j++) {
+            paper_store_add(
+                &g->papers,
+                rand_v2(&g->rand, v2_of(0), v2_of(TARGET_WIDTH, TARGET_HEIGHT)),
+                v2_of(0),
+                rand_n(&g->rand, 0, 2));
+
+            cars_spawn_random(&g->rand, true);
+
+            const v2 pos =
+                rand_v2(&g->rand, v2_of(0), v2_of(TARGET_WIDTH, TARGET_HEIGHT));
+            bomb_add(v2_of(pos.x, TARGET_HEIGHT), pos);
+
+            for (int k = 0; k < 4; k++) {
+                particles_emit(
+                    &g->particles,
+                    pos,
+                    v2_scale(rand_v2_dir(&g->rand), 40.0f),
+                    palette_get(3),
+                    rand_n(&g->rand, 30, 240));
+            }
+        }
+
+        u64 start = time_ns();
+        for (int j = 0; j < iters; j++) {
+            sim_snapshot(&s);
+        }
+        const f64 snapshot_s = NS_TO_SECS(time_ns() - start) / iters;
+
+        start = time_ns();
+        for (int j = 0; j < iters; j++) {
+            sim_restore(&s);
+        }
+        const f64 restore_s = NS_TO_SECS(time_ns() - start) / iters;
+
+        // rollback: the same ticks run from the same snapshot must agree
+        const hash_t before = headless_checksum();
+
+        char label[32];
+        snprintf(label, sizeof(label), "%5d entities rollback", n);
+
+        bool ok =
+            headless_compare(
+                &(headless_compare_t) {
+                    .label = label,
+                    .names = { "run", "rerun" },
+                    .unit = "tick",
+                    .steps = ticks,
+                    .setup = headless_snapshot_setup,
+                    .step = headless_snapshot_step,
+                    .checksum = headless_snapshot_checksum,
+                    .userdata = &s,
+                },
+                seed);
+
+        sim_restore(&s);
+        ok &= headless_checksum() == before;
+
+        LOG(
+            "%5d entities: snapshot %.1fus, restore %.1fus (%.1f KiB)%s",
+            n,
+            snapshot_s * 1000000.0,
+            restore_s * 1000000.0,
+            dynlist_size(s.data) / 1024.0,
+            ok ? "" : " MISMATCH");
+    }
+
+    sim_snapshot_destroy(&s);
+}
+
+// a busy bomb stage, cars topped up to n with a few bombs and n * 8 particles
+typedef struct {
+    int n, bombs_per_tick;
+    task_pool_t *pool;
+} headless_tasks_t;
+
+// pass 0 runs on the pool, pass 1 serially
+static void headless_tasks_setup(void *userdata, int pass) {
+    headless_tasks_t *ht = userdata;
+
+    g->tasks = pass == 0 ? ht->pool : NULL;
+    set_stage(STAGE_BOMB);
+    particles_clear(&g->particles);
+}
+
+static void headless_tasks_prepare(
+    void *userdata,
+    M_UNUSED int pass,
+    M_UNUSED int step) {
+    const headless_tasks_t *ht = userdata;
+
+    while (archetype_size(&g->cars) < ht->n) {
+        cars_spawn_random(&g->rand, true);
+    }
+
+    for (int j = 0; j < ht->bombs_per_tick; j++) {
+        const v2 pos =
+            v2_of(
+                rand_f32(&g->rand, 0.0f, TARGET_WIDTH),
+                rand_f32(&g->rand, TARGET_HEIGHT - 160, TARGET_HEIGHT - 95));
+        bomb_add(v2_of(pos.x, pos.y + rand_f32(&g->rand, 0.0f, 8.0f)), pos);
+    }
+
+    while (g->particles.size < ht->n * 8) {
+        particles_emit(
+            &g->particles,
+            rand_v2(&g->rand, v2_of(0), v2_of(TARGET_WIDTH, TARGET_HEIGHT)),
+            v2_scale(rand_v2_dir(&g->rand), 40.0f),
+            palette_get(3),
+            rand_n(&g->rand, 30, 240));
+    }
+}
+
+static void headless_tasks_step(
+    M_UNUSED void *userdata,
+    M_UNUSED int pass,
+    int step) {
+    cars_bombs_step(true);
+    particles_step(step, TICK_DT_S);
+}
+
+static hash_t headless_tasks_checksum(M_UNUSED void *userdata) {
+    return hash_add_int(headless_checksum(), g->score.car_total);
+}
+
+// the busy bomb stage stepped on pools of increasing size vs. serially. every
+// pool size must end in the same state as the serial run
+static void headless_bench_tasks(u64 seed) {
+    static const int threads[] = { 0, 1, 3, 7, 15 };
+
+    task_pool_t *tasks = g->tasks;
+
+    for (usize i = 0; i < ARRLEN(threads); i++) {
+        task_pool_t pool;
+        task_pool_init(&pool, threads[i], sim_task_enter);
+
+        headless_tasks_t ht = {
+            .n = 20000,
+            .bombs_per_tick = 2,
+            .pool = &pool,
+        };
+
+        char label[32];
+        snprintf(label, sizeof(label), "%2d pool threads", threads[i]);
+
+        headless_compare(
+            &(headless_compare_t) {
+                .label = label,
+                .names = { "pool", "serial" },
+                .unit = "tick",
+                .steps = 60,
+                .setup = headless_tasks_setup,
+                .prepare = headless_tasks_prepare,
+                .step = headless_tasks_step,
+                .checksum = headless_tasks_checksum,
+                .userdata = &ht,
+            },
+            seed);
+
+        g->tasks = tasks;
+        task_pool_destroy(&pool);
+    }
+
+    particles_clear(&g->particles);
+}
+
+// plays back a recording from game --record as fast as possible
+static void headless_replay(const char *path) {
+    if (replay_init_play(&g->replay, &g->arena, path)) {
+        return;
+    }
+
+    const u64 start = time_ns();
+
+    replay_frame_t rf;
+    while (replay_next_frame(&g->replay, &rf)) {
+        bump_allocator_reset(&g->frame_arena, 32 * 1024);
+        bump_allocator_reset(thread_scratch(), 1 * 1024 * 1024);
+
+        if (rf.tick != g->time.ticks) {
+            WARN(
+                "replay desync on frame %" PRIu64 ": tick %" PRIu64 ", recorded %" PRIu64,
+                g->replay.frames,
+                g->time.ticks,
+                rf.tick);
+        }
+
+        g->time.now = rf.now;
+        g->time.now_s = NS_TO_SECS(rf.now);
+        g->time.dt_s = NS_TO_SECS(rf.delta_ns);
+
+        input_update(
+            &g->input,
+            rf.now,
+            rf.window_size,
+            v2i_of(TARGET_WIDTH, TARGET_HEIGHT));
+
+        dynlist_each(g->replay.events, it) {
+            input_process(&g->input, it.el);
+        }
+
+        frame_step(rf.delta_ns);
+    }
+
+    const f64 elapsed_s = NS_TO_SECS(time_ns() - start);
+
+    LOG(
+        "replay: %" PRIu64 " frames, %" PRIu64 " ticks in %.3fs, %.1f frames/s (state %016" PRIx64 ")",
+        g->replay.frames,
+        g->time.ticks,
+        elapsed_s,
+        g->replay.frames / elapsed_s,
+        headless_checksum());
+
+    replay_destroy(&g->replay);
+}
+
+// inputs a bot can hold, fed to g->input as SDL events so bots go through
+// exactly the same code as players
+typedef enum {
+    BOT_SPACE = 0,
+    BOT_X,
+    BOT_LEFT,
+    BOT_RIGHT,
+    BOT_UP,
+    BOT_DOWN,
+    BOT_MOUSE,
+    BOT_INPUT_COUNT,
+} bot_input_e;
+
+static const char *bot_input_names[BOT_INPUT_COUNT] = {
+    [BOT_SPACE] = "space",
+    [BOT_X] = "x",
+    [BOT_LEFT] = "left",
+    [BOT_RIGHT] = "right",
+    [BOT_UP] = "up",
+    [BOT_DOWN] = "down",
+};
+
+typedef struct {
+    // separate from g->rand so bot decisions don't perturb the game
+    rand_t rand;
+
+    // inputs held after last tick, and wanted for this one
+    bool held[BOT_INPUT_COUNT], want[BOT_INPUT_COUNT];
+
+    // cursor position in target coordinates
+    v2 cursor;
+
+    // burn: offset from a paper's target center, ticks current paper held
+    v2 aim;
+    int hold_ticks;
+
+    // bomb: ticks until next drop
+    int reload;
+} bot_t;
+
+typedef struct {
+    int burn_right, burn_wrong;
+    int car_witness, car_civilian;
+    int judges;
+    bool won;
+    u64 ticks;
+} bot_result_t;
+
+// press input if it isn't down so it releases next tick
+static void bot_tap(bot_t *bot, bot_input_e i) {
+    bot->want[i] = !bot->held[i];
+}
+
+static v2 bot_burn_target(paper_type_e type) {
+    switch (type) {
+    case PAPER_KEEP: return BURN_CENTER_KEEP;
+    case PAPER_BURN: return BURN_CENTER_BURN;
+    case PAPER_IGNORE: return BURN_CENTER_IGNORE;
+    }
+
+    return v2_of(0);
+}
+
+// grab the nearest paper which isn't sorted and drag it to its center, letting
+// go once it has stopped there
+static void bot_burn(bot_t *bot) {
+    if (g->stage_ticks_left == 0) {
+        bot_tap(bot, BOT_SPACE);
+        return;
+    }
+
+    paper_store_t *ps = &g->papers;
+
+    if (paper_store_valid(ps, g->cur_paper.id)) {
+        const int i = g->cur_paper.id.index;
+        const v2
+            pos = paper_pos(ps, i),
+            center = boxf_center(paper_box(pos)),
+            target = v2_add(bot_burn_target(ps->type[i]), bot->aim);
+
+        // papers are pulled so that pos + offset sits under the cursor
+        bot->cursor =
+            v2_add(target, v2_sub(g->cur_paper.offset, v2_sub(center, pos)));
+
+        const bool settled =
+            v2_distance(center, target) < 4.0f
+            && v2_norm(g->cursor.delta_smooth) < 0.5f
+            && v2_norm(paper_vel(ps, i)) < 20.0f;
+
+        bot->hold_ticks++;
+        bot->want[BOT_MOUSE] =
+            !settled && bot->hold_ticks < 3 * TICKS_PER_SECOND;
+        return;
+    }
+
+    bot->want[BOT_MOUSE] = false;
+    bot->hold_ticks = 0;
+
+    if (bot->held[BOT_MOUSE]) { return; }
+
+    int best = -1;
+    f32 best_dist = 1e30f;
+
+    for (int i = 0; i < ps->size; i++) {
+        const v2 center = boxf_center(paper_box(paper_pos(ps, i)));
+
+        if (center.x < 0 || center.x >= TARGET_WIDTH
+            || center.y < 0 || center.y >= TARGET_HEIGHT
+            || v2_distance(center, bot_burn_target(ps->type[i]))
+                < BURN_CENTER_RADIUS * 0.5f) {
+            continue;
+        }
+
+        const f32 dist = v2_distance(center, bot->cursor);
+        if (dist < best_dist) {
+            best = i;
+            best_dist = dist;
+        }
+    }
+
+    if (best == -1) { return; }
+
+    bot->cursor = boxf_center(paper_box(paper_pos(ps, best)));
+    bot->want[BOT_MOUSE] = true;
+    bot->aim =
+        v2_scale(
+            rand_v2_dir(&bot->rand),
+            rand_f32(&bot->rand, 0.0f, BURN_CENTER_RADIUS * 0.4f));
+}
+
+// steer the cursor to where the nearest red car will be when a bomb dropped
+// now lands and drop it
+static void bot_bomb(bot_t *bot) {
+    if (g->stage_ticks_left == 0) {
+        bot_tap(bot, BOT_SPACE);
+        return;
+    }
+
+    const v2 cur = g->bomb.cur_pos;
+
+    bool found = false;
+    v2 target = cur;
+    f32 best_dist = 1e30f;
+
+    archetype_each(&g->cars, i) {
+        if (car_type(i) != CAR_RED) { continue; }
+
+        const v2 center = boxf_center(car_box(*car_pos(i)));
+
+        // ticks for a bomb dropped here to land
+        v2 bomb = v2_of(center.x, TARGET_HEIGHT);
+        int n = 0;
+        while (bomb.y > center.y) {
+            bomb.y -= bomb_speed(bomb, center) * TICK_DT_S;
+            n++;
+        }
+
+        const v2 hit =
+            v2_of(
+                center.x
+                    + ((car_right(i) ? 1 : -1)
+                        * car_speed(i) * TICK_DT_S * n),
+                center.y);
+
+        if (hit.x < 0 || hit.x >= TARGET_WIDTH) { continue; }
+
+        const f32 dist = v2_distance(hit, cur);
+        if (dist < best_dist) {
+            found = true;
+            target = hit;
+            best_dist = dist;
+        }
+    }
+
+    // velocity control, damped toward target
+    const v2 want_vel =
+        v2_clampv(
+            v2_scale(v2_sub(target, cur), 4.0f),
+            v2_of(-150.0f),
+            v2_of(150.0f));
+    const v2 vel = g->bomb.cur_vel;
+
+    bot->want[BOT_LEFT] = vel.x > want_vel.x + 5.0f;
+    bot->want[BOT_RIGHT] = vel.x < want_vel.x - 5.0f;
+    bot->want[BOT_DOWN] = vel.y > want_vel.y + 5.0f;
+    bot->want[BOT_UP] = vel.y < want_vel.y - 5.0f;
+
+    if (bot->reload > 0) {
+        bot->reload--;
+    } else if (found && best_dist < 3.0f) {
+        bot_tap(bot, BOT_X);
+        bot->reload = rand_n(&bot->rand, 10, 30);
+    }
+}
+
+// wrapped manhattan distance between bribe grid cells
+static int bot_bribe_dist(v2i a, v2i b) {
+    return
+        abs(bribe_wrap_delta(a.x, b.x, BG_WIDTH))
+            + abs(bribe_wrap_delta(a.y, b.y, BG_HEIGHT));
+}
+
+// head for money until there is some, then judges, keeping away from cops
+static void bot_bribe(bot_t *bot) {
+    for (int i = BOT_LEFT; i <= BOT_DOWN; i++) {
+        bot->want[i] = false;
+    }
+
+    if (g->stage_ticks_left == 0 || g->bribe.caught) {
+        bot_tap(bot, BOT_SPACE);
+        return;
+    }
+
+    const v2i player = g->bribe.player;
+
+    bool found = false;
+    v2i target = player;
+    int best_dist = INT_MAX;
+
+    const bool want_judge = g->bribe.money > 0 && g->bribe.judges.n > 0;
+
+    const v2i *targets =
+        want_judge ? g->bribe.judges.arr : g->bribe.monies.arr;
+    const int n_targets =
+        want_judge ? g->bribe.judges.n : g->bribe.monies.n;
+
+    for (int i = 0; i < n_targets; i++) {
+        const int dist = bot_bribe_dist(player, targets[i]);
+        if (dist < best_dist) {
+            found = true;
+            target = targets[i];
+            best_dist = dist;
+        }
+    }
+
+    static const bot_input_e keys[4] = {
+        BOT_RIGHT, BOT_LEFT, BOT_UP, BOT_DOWN,
+    };
+
+    // bribe_dirs order, stay put if every move is worse than staying
+    int best = -1;
+    int best_score = found ? bot_bribe_dist(player, target) + 1 : INT_MAX;
+
+    for (int d = 0; d < (int) ARRLEN(bribe_dirs); d++) {
+        const v2i next = bribe_wrap(v2i_add(player, bribe_dirs[d]));
+        if (bribe_board_get(&g->bribe.wall_board, next)) { continue; }
+
+        int score = found ? bot_bribe_dist(next, target) : 0;
+
+        fixlist_each(g->bribe.cops, it) {
+            if (bot_bribe_dist(next, *it.el) <= 2) {
+                score += 100;
+            }
+        }
+
+        if (score < best_score) {
+            best = d;
+            best_score = score;
+        }
+    }
+
+    if (best != -1) {
+        bot->want[keys[best]] = true;
+    }
+}
+
+static void bot_input(bot_t *bot) {
+    if (g->eval.enabled) {
+        bot_tap(bot, BOT_SPACE);
+    } else {
+        switch (g->stage) {
+        case STAGE_BURN: bot_burn(bot); break;
+        case STAGE_BOMB: bot_bomb(bot); break;
+        case STAGE_BRIBE: bot_bribe(bot); break;
+        }
+    }
+
+    SDL_Event ev = { 0 };
+    ev.motion.type = SDL_MOUSEMOTION;
+    ev.motion.x = (int) bot->cursor.x;
+    ev.motion.y = TARGET_HEIGHT - 1 - (int) bot->cursor.y;
+    input_process(&g->input, &ev);
+
+    for (int i = 0; i < BOT_INPUT_COUNT; i++) {
+        if (bot->want[i] == bot->held[i]) { continue; }
+
+        ev = (SDL_Event) { 0 };
+
+        if (i == BOT_MOUSE) {
+            ev.button.type =
+                bot->want[i] ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+            ev.button.button = SDL_BUTTON_LEFT;
+        } else {
+            ev.key.type = bot->want[i] ? SDL_KEYDOWN : SDL_KEYUP;
+            ev.key.keysym.sym = SDL_GetKeyFromName(bot_input_names[i]);
+        }
+
+        input_process(&g->input, &ev);
+        bot->held[i] = bot->want[i];
+    }
+
+    // taps are released next tick
+    bot->want[BOT_SPACE] = false;
+    bot->want[BOT_X] = false;
+}
+
+// plays one full game (burn, bomb, bribe, through to the final evaluation)
+// with a bot in g
+static bot_result_t bot_game(u64 seed) {
+    const u64 max_ticks =
+        (STAGE_BURN_SECONDS + STAGE_BOMB_SECONDS + (4 * STAGE_BRIBE_SECONDS) + 60)
+            * TICKS_PER_SECOND;
+
+    bot_t bot = {
+        .rand = rand_create(hash_add_u64(seed, 0xB07)),
+        .cursor = v2_of(TARGET_WIDTH / 2.0f, TARGET_HEIGHT / 2.0f),
+    };
+
+    rand_seed(&g->rand, seed);
+    input_destroy(&g->input);
+    input_init(&g->input, g_mallocator, NULL);
+    g->time.ticks = 0;
+    g->main_menu = false;
+    g->cursor = (typeof(g->cursor)) { 0 };
+    set_stage(STAGE_BURN);
+
+    while (!g->main_menu && g->time.ticks < max_ticks) {
+        bump_allocator_reset(&g->frame_arena, 32 * 1024);
+        bump_allocator_reset(thread_scratch(), 1 * 1024 * 1024);
+
+        input_update(
+            &g->input,
+            g->time.ticks * NS_PER_TICK,
+            v2i_of(TARGET_WIDTH, TARGET_HEIGHT),
+            v2i_of(TARGET_WIDTH, TARGET_HEIGHT));
+        bot_input(&bot);
+
+        update(TICK_DT_S);
+        tick();
+
+        g->time.ticks++;
+    }
+
+    if (!g->main_menu) {
+        WARN("bot game %016" PRIx64 " did not finish", seed);
+    }
+
+    return (bot_result_t) {
+        .burn_right =
+            g->score.burn_keep + g->score.burn_burn + g->score.burn_ignore,
+        .burn_wrong = g->score.burn_wrong,
+        .car_witness = g->score.car_witness,
+        .car_civilian = g->score.car_civilian,
+        .judges = g->score.judges,
+        .won = g->main_menu && g->eval.won,
+        .ticks = g->time.ticks,
+    };
+}
+
+typedef struct {
+    mtx_t lock;
+    int next, n;
+    u64 seed;
+    bot_result_t *results;
+} bot_pool_t;
+
+// runs games from pool in a global_t of its own until there are none left
+static int bot_worker(void *arg) {
+    bot_pool_t *pool = arg;
+
+    g = mem_calloc(g_mallocator, sizeof(global_t));
+    init();
+
+    while (true) {
+        ASSERT(mtx_lock(&pool->lock) == thrd_success);
+        const int i = pool->next++;
+        ASSERT(mtx_unlock(&pool->lock) == thrd_success);
+
+        if (i >= pool->n) { break; }
+
+        pool->results[i] = bot_game(hash_add_int(pool->seed, i));
+    }
+
+    deinit();
+    mem_free(g_mallocator, g);
+    g = &_global;
+    return 0;
+}
+
+// logs mean/percentiles of one field of results
+#define BOT_STAT(_results, _n, _field) do {                                   \
+        i32 *_v = mem_alloc(thread_scratch(), (_n) * sizeof(i32));            \
+        f64 _sum = 0.0;                                                       \
+        for (int _i = 0; _i < (_n); _i++) {                                   \
+            _v[_i] = (_results)[_i]._field;                                   \
+            _sum += _v[_i];                                                   \
+        }                                                                     \
+        sort(_v, (_n), sizeof(i32), i32_cmp, NULL);                           \
+        LOG(                                                                  \
+            "  %-12s mean %6.2f  p10 %3d  p50 %3d  p90 %3d  max %3d",         \
+            #_field,                                                          \
+            _sum / (_n),                                                      \
+            _v[(_n) / 10],                                                    \
+            _v[(_n) / 2],                                                     \
+            _v[((_n) * 9) / 10],                                              \
+            _v[(_n) - 1]);                                                    \
+    } while (0)
+
+// plays n bot games spread over workers threads, each with its own global_t
+// and RNG stream, and reports score distributions and throughput. n and
+// workers must be at least 1
+static void headless_bots(int n, int workers, u64 seed) {
+    ASSERT(n > 0 && workers > 0);
+
+    bot_pool_t pool = {
+        .n = n,
+        .seed = seed,
+        .results = mem_calloc(g_mallocator, n * sizeof(bot_result_t)),
+    };
+    ASSERT(mtx_init(&pool.lock, mtx_plain) == thrd_success);
+
+    thrd_t *threads = mem_alloc(g_mallocator, workers * sizeof(thrd_t));
+
+    const u64 start = time_ns();
+
+    for (int i = 0; i < workers; i++) {
+        ASSERT(thrd_create(&threads[i], bot_worker, &pool) == thrd_success);
+    }
+
+    for (int i = 0; i < workers; i++) {
+        thrd_join(threads[i], NULL);
+    }
+
+    const f64 elapsed_s = NS_TO_SECS(time_ns() - start);
+
+    u64 ticks = 0;
+    int won = 0;
+    for (int i = 0; i < n; i++) {
+        ticks += pool.results[i].ticks;
+        won += pool.results[i].won;
+    }
+
+    const int cores = max(min(workers, SDL_GetCPUCount()), 1);
+
+    LOG(
+        "bots: %d games on %d workers in %.3fs, %.1f games/s (%.1f/s per core), %.0f ticks/s",
+        n,
+        workers,
+        elapsed_s,
+        n / elapsed_s,
+        n / elapsed_s / cores,
+        ticks / elapsed_s);
+
+    BOT_STAT(pool.results, n, burn_right);
+    BOT_STAT(pool.results, n, burn_wrong);
+    BOT_STAT(pool.results, n, car_witness);
+    BOT_STAT(pool.results, n, car_civilian);
+    BOT_STAT(pool.results, n, judges);
+    LOG("  won          %.1f%%", (100.0 * won) / n);
+
+    mtx_destroy(&pool.lock);
+    mem_free(g_mallocator, threads);
+    mem_free(g_mallocator, pool.results);
+}
+
+// seed of headless runs and benchmarks when none is given
+#define HEADLESS_SEED 0x12345
+
+// benchmarks which take only a seed
+static const struct {
+    const char *name;
+    void (*fn)(u64 seed);
+} headless_benches[] = {
+    { "papers", headless_bench_papers },
+    { "particles", headless_bench_particles },
+    { "cars", headless_bench_cars },
+    { "snapshot", headless_bench_snapshot },
+    { "tasks", headless_bench_tasks },
+    { "sprites", headless_bench_sprites },
+    { "pack", headless_bench_pack },
+};
+
+// logged when the mode is not recognised, along with the names in
+// headless_benches
+static const char *headless_usage =
+    "usage:\n"
+    "  game-headless [burn|bomb|bribe|all] [ticks] [seed]\n"
+    "  game-headless <benchmark> [seed]\n"
+    "  game-headless bots [games] [workers] [seed]\n"
+    "  game-headless replay <path>";
+
+static void headless_frame() {
+    const int argc = cjam_argc();
+    char **argv = cjam_argv();
+
+    const char *which = argc > 1 ? argv[1] : "all";
+
+    for (usize i = 0; i < ARRLEN(headless_benches); i++) {
+        if (!strcmp(which, headless_benches[i].name)) {
+            headless_benches[i].fn(
+                argc > 2 ? strtoull(argv[2], NULL, 0) : HEADLESS_SEED);
+            cjam_quit();
+            return;
+        }
+    }
+
+    if (!strcmp(which, "bots")) {
+        headless_bots(
+            argc > 2 ? max(atoi(argv[2]), 1) : 1000,
+            argc > 3 ? max(atoi(argv[3]), 1) : SDL_GetCPUCount(),
+            argc > 4 ? strtoull(argv[4], NULL, 0) : HEADLESS_SEED);
+        cjam_quit();
+        return;
+    }
+
+    if (!strcmp(which, "replay") && argc > 2) {
+        headless_replay(argv[2]);
+        cjam_quit();
+        return;
+    }
+
+    const usize n = argc > 2 ? strtoull(argv[2], NULL, 10) : 100000;
+    const u64 seed = argc > 3 ? strtoull(argv[3], NULL, 0) : HEADLESS_SEED;
+
+    bool found = false;
+    for (stage_e stage = STAGE_BURN; stage <= STAGE_BRIBE; stage++) {
+        if (!strcmp(which, "all") || !strcmp(which, stage_name(stage))) {
+            headless_run(stage, n, seed);
+            found = true;
+        }
+    }
+
+    if (!found) {
+        char benches[256];
+        usize len = 0;
+        benches[0] = '\0';
+
+        for (usize i = 0; i < ARRLEN(headless_benches); i++) {
+            len += snprintf(
+                &benches[len],
+                sizeof(benches) - len,
+                "%s%s",
+                i == 0 ? "" : ", ",
+                headless_benches[i].name);
+            ASSERT(len < sizeof(benches));
+        }
+
+        ERROR(
+            "unknown mode \"%s\"\n%s\nbenchmarks: %s",
+            which,
+            headless_usage,
+            benches);
+        cjam_exit(1);
+        return;
+    }
+
+    cjam_quit();
+}
+#endif // ifdef HEADLESS
+
+static void frame() {
+#ifdef HEADLESS
+    // headless builds only ever run the simulation benchmark
+    headless_frame();
+#else
+
+    // wait out the rest of the frame before input is polled, so input is as
+    // fresh as possible when it is simulated. the browser paces frames itself
+#ifdef EMSCRIPTEN
+    const u64 now = time_ns();
+#else
+    if (g->idle.active) {
+        // nothing to draw until an event arrives or the screen next changes
+        const u64 wait = idle_wait_ns();
+        if (wait > 0) {
+            SDL_WaitEventTimeout(NULL, (int) ((wait + 999999) / 1000000));
+        }
+
+        frame_pacer_resync(&g->pacer);
+    }
+
+    const u64 now = frame_pacer_wait(&g->pacer);
+#endif // ifdef EMSCRIPTEN
+
+    bump_allocator_reset(&g->frame_arena, 32 * 1024);
+
+    static u64 last_frame = 0, delta = 0;
+    delta = now - last_frame;
+    last_frame = now;
+
+    g->time.now = now;
+    g->time.now_s = NS_TO_SECS(now);
+
+    if ((g->time.now - g->time.last_second) >= 1000000000) {
+        g->time.last_second = now;
+        g->time.fps = g->time.second_frames;
+        g->time.second_frames = 0;
+        g->time.tps = g->time.second_ticks;
+        g->time.second_ticks = 0;
+
+        LOG(
+            "fps: %" PRIu64 " / tps: %" PRIu64
+            " / coalesced: %" PRIu64 " / dropped: %" PRIu64,
+            g->time.fps,
+            g->time.tps,
+            g->time.coalesced_ticks,
+            g->time.dropped_ticks);
+
+        const frame_pacer_stats_t *ps = &g->pacer.stats;
+        if (ps->n != 0) {
+            LOG(
+                "frame: %.2fms avg / %.2fms jitter / %.2f-%.2fms"
+                " / late: %" PRIu64 " / slept %.0fms, spun %.1fms",
+                ps->mean / 1000000.0,
+                frame_pacer_jitter(ps) / 1000000.0,
+                ps->min / 1000000.0,
+                ps->max / 1000000.0,
+                ps->late,
+                ps->sleep_ns / 1000000.0,
+                ps->spin_ns / 1000000.0);
+        }
+
+        if (g->idle.skipped != 0) {
+            LOG("idle: %" PRIu64 " frames not drawn", g->idle.skipped);
+        }
+
+        const sprite_stats_t *ss = sprite_stats();
+        const u64 drawn = max(g->time.fps, 1);
+        LOG(
+            "sprites: %.1fKiB / %.1f chunks per frame / %d buffers"
+            " / dropped: %" PRIu64,
+            ss->bytes / 1024.0 / drawn,
+            (f64) ss->chunks / drawn,
+            ss->buffers,
+            ss->dropped);
+        sprite_reset_stats();
+
+        g->idle.skipped = 0;
+
+        frame_pacer_reset_stats(&g->pacer);
+    }
+
+    v2i window_size;
+    SDL_GetWindowSize(g->window, &window_size.x, &window_size.y);
+
+    // when replaying, timing and input come from the recording instead
+    replay_frame_t rf = {
+        .tick = g->time.ticks,
+        .now = now,
+        .delta_ns = delta,
+        .window_size = window_size,
+    };
+
+    if (g->replay.mode == REPLAY_PLAY) {
+        if (!replay_next_frame(&g->replay, &rf)) {
+            LOG("replay finished after %" PRIu64 " frames", g->replay.frames);
+            replay_destroy(&g->replay);
+            cjam_quit();
+            return;
+        }
+
+        if (rf.tick != g->time.ticks) {
+            WARN(
+                "replay desync: frame started on tick %" PRIu64 ", recorded %" PRIu64,
+                g->time.ticks,
+                rf.tick);
+        }
+
+        delta = rf.delta_ns;
+    } else if (g->replay.mode == REPLAY_RECORD) {
+        replay_record_frame(&g->replay, &rf);
+    }
+
+    g->time.dt_s = NS_TO_SECS(delta);
+
+    input_update(
+        &g->input,
+        rf.now,
+        rf.window_size,
+        v2i_of(TARGET_WIDTH, TARGET_HEIGHT));
+
+    // any event (input, window expose/resize, ...) may change what is on
+    // screen
+    bool events = false;
+
+    SDL_Event ev;
+    while (SDL_PollEvent(&ev)) {
+        events = true;
+
+        switch (ev.type) {
+        case SDL_QUIT:
+            cjam_quit();
+            break;
+        }
+
+        // live input is ignored while replaying
+        if (g->replay.mode == REPLAY_PLAY) {
+            continue;
+        } else if (g->replay.mode == REPLAY_RECORD) {
+            replay_record_event(&g->replay, &ev);
+        }
+
+        input_process(&g->input, &ev);
+    }
+
+    if (g->replay.mode == REPLAY_PLAY) {
+        dynlist_each(g->replay.events, it) {
+            input_process(&g->input, it.el);
+        }
+    }
+
+    sprite_batch_init(&g->batch, &g->frame_arena, &g->atlas);
+    sprite_batch_init(&g->font_batch, &g->frame_arena, &g->font_atlas);
+    sprite_image_batch_init(&g->image_batch, &g->frame_arena);
+
+    frame_step(delta);
+    stress_step();
+
+    // what is on screen is still current, don't draw or swap
+    const hash_t idle_key = idle_scene_key();
+    g->idle.active = idle_key != 0 && idle_key == g->idle.key && !events;
+    g->idle.key = idle_key;
+
+    if (g->idle.active) {
+        sound_update(NS_TO_SECS(delta));
+        g->idle.skipped++;
+        return;
+    }
+
+    v4 clear_color = palette_get(0);
+
+    if (g->main_menu) {
+        clear_color = palette_get(3);
+    } else {
+        switch (g->stage) {
+        case STAGE_BURN: clear_color = palette_get(0); break;
+        case STAGE_BOMB: clear_color = palette_get(29); break;
+        case STAGE_BRIBE: clear_color = palette_get(36); break;
+          break;
+        }
+    }
+
+    sg_begin_pass(
+        &(sg_pass) {
+            .attachments = g->offscreen.attachments,
+            .action = {
+                .colors[0] = {
+                    .load_action = SG_LOADACTION_CLEAR,
+                    .clear_value = { clear_color.r, clear_color.g, clear_color.b, 1.0f },
+                },
+                .depth = {
+                    .load_action = SG_LOADACTION_CLEAR,
+                    .clear_value = 1.0f,
+                },
+            },
+        });
+    {
+        const m4
+            view = m4_identity(),
+            proj =
+                cam_ortho(
+                    0.0f, TARGET_WIDTH, 0.0f, TARGET_HEIGHT, 1.0f, -1.0f);
+        render(&view, &proj);
+
+        // images are opaque and behind most sprites, draw them first so
+        // translucent sprites blend over them. text is in front of every
+        // sprite, draw it last so translucent text blends over them
+        sprite_image_batch_draw(&g->image_batch, NULL, &view, &proj);
+        sprite_batch_sort(&g->batch);
+        sprite_batch_sort(&g->font_batch);
+        sprite_batch_draw(&g->batch, NULL, &view, &proj);
+        sprite_batch_draw(&g->font_batch, NULL, &view, &proj);
     }
     sg_end_pass();
 
@@ -1855,6 +4701,7 @@ static void frame() {
 
     g->time.second_frames++;
     g->time.frames++;
+#endif // ifdef HEADLESS
 }
 
 cjam_desc_t cjam_main() {
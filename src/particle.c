@@ -0,0 +1,265 @@
+#include "particle.h"
+#include "font.h"
+#include "util/alloc.h"
+#include "util/assert.h"
+#include "util/mem.h"
+#include "util/simd.h"
+#include "util/sprite.h"
+
+void particles_init(particles_t *ps, allocator_t *al) {
+    *ps = (particles_t) {
+        .allocator = al,
+        .texts = dynlist_create(particle_text_t, al),
+    };
+}
+
+void particles_destroy(particles_t *ps) {
+    if (ps->capacity > 0) {
+        mem_free(ps->allocator, ps->x);
+        mem_free(ps->allocator, ps->y);
+        mem_free(ps->allocator, ps->vx);
+        mem_free(ps->allocator, ps->vy);
+        mem_free(ps->allocator, ps->floor_y);
+        mem_free(ps->allocator, ps->spawn);
+        mem_free(ps->allocator, ps->duration);
+        mem_free(ps->allocator, ps->color);
+    }
+
+    dynlist_destroy(ps->texts);
+    *ps = (particles_t) { 0 };
+}
+
+void particles_clear(particles_t *ps) {
+    ps->size = 0;
+    dynlist_resize_no_contract(ps->texts, 0);
+}
+
+static void grow(particles_t *ps) {
+    const int capacity = max(ps->capacity * 2, 64 * SIMD_LANES);
+
+    // fresh lanes are zeroed so padding never holds NaNs
+#define GROW(_a) do {                                                         \
+        typeof(ps->_a) _p = mem_calloc(ps->allocator, capacity * sizeof(*_p));\
+        if (ps->_a) {                                                         \
+            memcpy(_p, ps->_a, ps->size * sizeof(*_p));                       \
+            mem_free(ps->allocator, ps->_a);                                  \
+        }                                                                     \
+        ps->_a = _p;                                                          \
+    } while (0)
+
+    GROW(x);
+    GROW(y);
+    GROW(vx);
+    GROW(vy);
+    GROW(floor_y);
+    GROW(spawn);
+    GROW(duration);
+    GROW(color);
+#undef GROW
+
+    ps->capacity = capacity;
+}
+
+void particles_emit(particles_t *ps, v2 pos, v2 vel, v4 color, int duration) {
+    if (ps->size == ps->capacity) {
+        grow(ps);
+    }
+
+    const int i = ps->size++;
+    ps->x[i] = pos.x;
+    ps->y[i] = pos.y;
+    ps->vx[i] = vel.x;
+    ps->vy[i] = vel.y;
+    ps->floor_y[i] = pos.y - 4.0f;
+    ps->spawn[i] = PARTICLE_UNSPAWNED;
+    ps->duration[i] = duration;
+    ps->color[i] = color;
+}
+
+void particles_emit_text(
+    particles_t *ps,
+    v2 pos,
+    v4 color,
+    int duration,
+    const char *text) {
+    particle_text_t *t = dynlist_push(ps->texts);
+    *t = (particle_text_t) {
+        .pos = pos,
+        .color = color,
+        .spawn = PARTICLE_UNSPAWNED,
+        .duration = duration,
+    };
+    snprintf(t->text, sizeof(t->text), "%s", text);
+}
+
+void particles_integrate(particles_t *ps, f32 dt, int first, int last) {
+    const f32x4
+        vdt = f32x4_splat(dt),
+        damp = f32x4_splat(1.0f - (0.9f * dt)),
+        gravity = f32x4_splat(20.0f * dt),
+        bounce = f32x4_splat(-0.9f),
+        zero = f32x4_splat(0.0f);
+
+    first = round_up_to_mult(max(first, 0), SIMD_LANES);
+    last = min(last, ps->size);
+
+    for (int i = first; i < last; i += SIMD_LANES) {
+        f32x4
+            x = f32x4_load(&ps->x[i]),
+            y = f32x4_load(&ps->y[i]),
+            vx = f32x4_load(&ps->vx[i]),
+            vy = f32x4_load(&ps->vy[i]);
+        const f32x4 floor_y = f32x4_load(&ps->floor_y[i]);
+
+        x += vx * vdt;
+        y += vy * vdt;
+        vx *= damp;
+        vy *= damp;
+        vy -= gravity;
+        vy = f32x4_select((y <= floor_y) & (vy < zero), vy * bounce, vy);
+
+        f32x4_store(&ps->x[i], x);
+        f32x4_store(&ps->y[i], y);
+        f32x4_store(&ps->vx[i], vx);
+        f32x4_store(&ps->vy[i], vy);
+    }
+}
+
+void particles_update(particles_t *ps, u64 tick, f32 dt) {
+    particles_integrate(ps, dt, 0, ps->size);
+    particles_retire(ps, tick, dt);
+}
+
+void particles_retire(particles_t *ps, u64 tick, f32 dt) {
+    // spawn new particles and compact out expired ones in one pass, nothing
+    // moves until the first expired particle
+    int n = 0;
+    for (int i = 0; i < ps->size; i++) {
+        if (ps->spawn[i] == PARTICLE_UNSPAWNED) {
+            ps->spawn[i] = tick;
+        }
+
+        if (tick - ps->spawn[i] >= (u64) ps->duration[i]) {
+            continue;
+        }
+
+        if (n != i) {
+            ps->x[n] = ps->x[i];
+            ps->y[n] = ps->y[i];
+            ps->vx[n] = ps->vx[i];
+            ps->vy[n] = ps->vy[i];
+            ps->floor_y[n] = ps->floor_y[i];
+            ps->spawn[n] = ps->spawn[i];
+            ps->duration[n] = ps->duration[i];
+            ps->color[n] = ps->color[i];
+        }
+
+        n++;
+    }
+    ps->size = n;
+
+    n = 0;
+    dynlist_each(ps->texts, it) {
+        particle_text_t *t = it.el;
+
+        if (t->spawn == PARTICLE_UNSPAWNED) {
+            t->spawn = tick;
+        }
+
+        t->pos.y += 10.0f * dt;
+
+        if (tick - t->spawn >= (u64) t->duration) {
+            continue;
+        }
+
+        if (n != it.i) {
+            ps->texts[n] = *t;
+        }
+
+        n++;
+    }
+    dynlist_resize_no_contract(ps->texts, n);
+}
+
+void particles_render(
+    const particles_t *ps,
+    sprite_batch_t *batch,
+    sprite_batch_t *font_batch,
+    f32 z,
+    f32 z_step) {
+    sprite_batch_push_subimages(
+        batch,
+        boxi_ps(v2i_of(40, 16), v2i_of(1, 1)),
+        ps->size,
+        ps->x,
+        ps->y,
+        ps->color,
+        z,
+        z_step,
+        SPRITE_NO_FLAGS);
+
+    dynlist_each(ps->texts, it) {
+        const int width = font_width(it.el->text);
+        font_str(
+            font_batch,
+            it.el->text,
+            &(font_params_t) {
+                .pos = v2_of(it.el->pos.x - (width / 2.0f), it.el->pos.y),
+                .z = z + (it.i * z_step),
+                .color = it.el->color,
+                .flags = FONT_DOUBLED,
+            });
+    }
+}
+
+usize particles_save(const particles_t *ps, void *dst) {
+    u8 *p = dst;
+    usize n = 0;
+
+    const int n_texts = dynlist_size(ps->texts);
+    memput(p, &n, &ps->size, sizeof(ps->size));
+    memput(p, &n, &n_texts, sizeof(n_texts));
+
+    memput(p, &n, ps->x, ps->size * sizeof(*ps->x));
+    memput(p, &n, ps->y, ps->size * sizeof(*ps->y));
+    memput(p, &n, ps->vx, ps->size * sizeof(*ps->vx));
+    memput(p, &n, ps->vy, ps->size * sizeof(*ps->vy));
+    memput(p, &n, ps->floor_y, ps->size * sizeof(*ps->floor_y));
+    memput(p, &n, ps->spawn, ps->size * sizeof(*ps->spawn));
+    memput(p, &n, ps->duration, ps->size * sizeof(*ps->duration));
+    memput(p, &n, ps->color, ps->size * sizeof(*ps->color));
+    memput(p, &n, ps->texts, n_texts * sizeof(*ps->texts));
+
+    return n;
+}
+
+usize particles_restore(particles_t *ps, const void *src) {
+    const u8 *p = src;
+
+    int size, n_texts;
+    memget(&p, &size, sizeof(size));
+    memget(&p, &n_texts, sizeof(n_texts));
+
+    while (ps->capacity < size) {
+        grow(ps);
+    }
+
+    ps->size = size;
+    memget(&p, ps->x, size * sizeof(*ps->x));
+    memget(&p, ps->y, size * sizeof(*ps->y));
+    memget(&p, ps->vx, size * sizeof(*ps->vx));
+    memget(&p, ps->vy, size * sizeof(*ps->vy));
+    memget(&p, ps->floor_y, size * sizeof(*ps->floor_y));
+    memget(&p, ps->spawn, size * sizeof(*ps->spawn));
+    memget(&p, ps->duration, size * sizeof(*ps->duration));
+    memget(&p, ps->color, size * sizeof(*ps->color));
+
+    dynlist_resize_no_contract(ps->texts, n_texts);
+    memget(&p, ps->texts, n_texts * sizeof(*ps->texts));
+
+    return p - (const u8*) src;
+}
+
+int particles_count(const particles_t *ps) {
+    return ps->size + dynlist_size(ps->texts);
+}
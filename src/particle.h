@@ -0,0 +1,92 @@
+#pragma once
+
+#include "util/types.h"
+#include "util/math.h"
+#include "util/dynlist.h"
+#include "defs.h"
+
+typedef struct allocator allocator_t;
+
+// particles spawn lazily: their lifetime starts on the first particles_update
+// after they are emitted
+#define PARTICLE_UNSPAWNED UINT64_MAX
+
+typedef struct {
+    v2 pos;
+    v4 color;
+    u64 spawn;
+    int duration;
+    char text[32];
+} particle_text_t;
+
+// pooled particle system. sprite particles are hot, stored SoA so they can be
+// integrated SIMD_LANES at a time and pushed to a sprite batch in one pass.
+// text particles are rare and kept separately so sprite particles don't carry
+// a text buffer. expired particles are retired in bulk by stable compaction,
+// so draw order is always emission order.
+typedef struct {
+    allocator_t *allocator;
+
+    // capacity is a multiple of SIMD_LANES, lanes past size hold junk
+    f32 *x, *y, *vx, *vy;
+
+    // y below which particles bounce, 4px under their spawn point
+    f32 *floor_y;
+
+    u64 *spawn;
+    int *duration;
+    v4 *color;
+
+    int size, capacity;
+
+    DYNLIST(particle_text_t) texts;
+} particles_t;
+
+void particles_init(particles_t *ps, allocator_t *al);
+
+void particles_destroy(particles_t *ps);
+
+void particles_clear(particles_t *ps);
+
+// emit a 1px sprite particle which lives for duration ticks
+void particles_emit(particles_t *ps, v2 pos, v2 vel, v4 color, int duration);
+
+// emit floating text which lives for duration ticks
+void particles_emit_text(
+    particles_t *ps,
+    v2 pos,
+    v4 color,
+    int duration,
+    const char *text);
+
+// integrate all particles and retire those which have expired as of tick
+void particles_update(particles_t *ps, u64 tick, f32 dt);
+
+// integrate sprite particles [first, last), first is rounded up to a multiple
+// of SIMD_LANES so disjoint ranges split on SIMD_LANES can be integrated
+// concurrently
+void particles_integrate(particles_t *ps, f32 dt, int first, int last);
+
+// move text particles and retire particles which have expired as of tick, the
+// second half of particles_update
+void particles_retire(particles_t *ps, u64 tick, f32 dt);
+
+// push sprite particles to batch and text particles to font_batch, particle i
+// is drawn at z + (i * z_step)
+void particles_render(
+    const particles_t *ps,
+    sprite_batch_t *batch,
+    sprite_batch_t *font_batch,
+    f32 z,
+    f32 z_step);
+
+// copies all particles into dst, which must have room for
+// particles_save(ps, NULL) bytes. returns number of bytes written
+usize particles_save(const particles_t *ps, void *dst);
+
+// replaces all particles with those saved at src by particles_save, returns
+// number of bytes read
+usize particles_restore(particles_t *ps, const void *src);
+
+// total number of live particles
+int particles_count(const particles_t *ps);